@@ -4,13 +4,20 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
+#include "fractal_render.h"
 
 #define WIDTH 800
 #define HEIGHT 600
 #define MAX_ITERATIONS 100
 #define COLOR_SCHEMES 6
+#define RENDER_BUDGET_MS 8.0    // refinement time per frame after a zoom
 
 static uint32_t pixels[HEIGHT*WIDTH];
+static int iterations[2][HEIGHT*WIDTH];
+static FractalCache fractal_cache;
+static uint32_t fractal_image[HEIGHT*WIDTH];   // colored field, reused while nothing changes
+static int image_color_scheme = -1;
 
 // Fractal state
 typedef struct {
@@ -76,27 +83,6 @@ static uint32_t color_palettes[COLOR_SCHEMES][16] = {
      0xFF6699FF, 0xFF9966FF, 0xFFCC33FF, 0xFFFF00FF}
 };
 
-// Function to calculate mandelbrot value for a point
-int calculate_mandelbrot(double cr, double ci, int max_iter) {
-    double zr = 0;
-    double zi = 0;
-    double zr2 = 0;
-    double zi2 = 0;
-    int i;
-    
-    for (i = 0; i < max_iter; i++) {
-        zi = 2 * zr * zi + ci;
-        zr = zr2 - zi2 + cr;
-        zr2 = zr * zr;
-        zi2 = zi * zi;
-        
-        if (zr2 + zi2 > 4)
-            break;
-    }
-    
-    return i;
-}
-
 // Map screen coordinates to mathematical coordinates
 void screen_to_math(int px, int py, double *x, double *y) {
     double aspect = (double)WIDTH / HEIGHT;
@@ -137,25 +123,80 @@ uint32_t get_mandelbrot_color(int iterations, int max_iterations) {
     return (0xFF << 24) | (r << 16) | (g << 8) | b;
 }
 
+// Colors image pixels [x0, x1) x [y0, y1) from the cached field, which has
+// one sample per step x step block.
+static void color_fractal_rect(const uint32_t* colors, int step, int x0, int y0, int x1, int y1) {
+    int grid_w = fractal_cache.view.width;
+    if (y1 > HEIGHT) y1 = HEIGHT;
+    for (int y = y0; y < y1; y++) {
+        const int* row = fractal_cache.iters + (y / step) * grid_w;
+        uint32_t* out = fractal_image + y * WIDTH;
+        for (int x = x0; x < x1; x++) {
+            out[x] = colors[row[x / step]];
+        }
+    }
+}
+
 // Render the fractal
 void render_fractal() {
     int step = state.high_quality ? 1 : 2;  // Quality setting
-    
-    for (int y = 0; y < HEIGHT; y += step) {
-        for (int x = 0; x < WIDTH; x += step) {
-            double cr, ci;
-            screen_to_math(x, y, &cr, &ci);
-            
-            int iterations = calculate_mandelbrot(cr, ci, state.max_iterations);
-            uint32_t color = get_mandelbrot_color(iterations, state.max_iterations);
-            
-            for (int dy = 0; dy < step && y+dy < HEIGHT; dy++) {
-                for (int dx = 0; dx < step && x+dx < WIDTH; dx++) {
-                    pixels[(y+dy) * WIDTH + (x+dx)] = color;
-                }
+    int grid_w = (WIDTH + step - 1) / step;
+    int grid_h = (HEIGHT + step - 1) / step;
+
+    // Low quality computes one sample per step x step block, centered the
+    // same way as the full-resolution grid.
+    FractalView view = {
+        .center_x = state.center_x,
+        .center_y = state.center_y,
+        .scale = state.zoom / HEIGHT * step,
+        .width = grid_w,
+        .height = grid_h,
+        .max_iterations = state.max_iterations
+    };
+    if (step > 1) {
+        // Keep the coarse grid on whole cells so odd-pixel pans still reuse it
+        view.center_x = floor(view.center_x / view.scale + 0.5) * view.scale;
+        view.center_y = floor(view.center_y / view.scale + 0.5) * view.scale;
+    }
+
+    if (!fractal_cache.iters) {
+        fractal_cache_init(&fractal_cache, iterations[0], iterations[1], HEIGHT * WIDTH);
+    }
+    int changed = fractal_cache_update(&fractal_cache, &view, RENDER_BUDGET_MS);
+
+    if (changed || image_color_scheme != state.color_scheme) {
+        // One palette lookup per iteration count instead of one per pixel
+        int max_iter = fractal_cache.view.max_iterations;
+        uint32_t colors[max_iter + 1];
+        for (int i = 0; i <= max_iter; i++) {
+            colors[i] = get_mandelbrot_color(i, max_iter);
+        }
+
+        // A pan moves the colored image with the field; only the strips it
+        // uncovered and the rows refined this frame need coloring.
+        int dx = fractal_cache.moved_x * step, dy = fractal_cache.moved_y * step;
+        if (fractal_cache.changed_all || image_color_scheme != state.color_scheme ||
+            abs(dx) >= WIDTH || abs(dy) >= HEIGHT) {
+            color_fractal_rect(colors, step, 0, 0, WIDTH, HEIGHT);
+        } else {
+            if (dx != 0 || dy != 0) {
+                fractal_shift_pixels(fractal_image, WIDTH, HEIGHT, dx, dy);
+                if (dy > 0)
+                    color_fractal_rect(colors, step, 0, HEIGHT - dy, WIDTH, HEIGHT);
+                else if (dy < 0)
+                    color_fractal_rect(colors, step, 0, 0, WIDTH, -dy);
+                if (dx > 0)
+                    color_fractal_rect(colors, step, WIDTH - dx, 0, WIDTH, HEIGHT);
+                else if (dx < 0)
+                    color_fractal_rect(colors, step, 0, 0, -dx, HEIGHT);
             }
+            color_fractal_rect(colors, step, 0, fractal_cache.dirty_y0 * step,
+                               WIDTH, fractal_cache.dirty_y1 * step);
         }
+        image_color_scheme = state.color_scheme;
     }
+
+    memcpy(pixels, fractal_image, sizeof(pixels));
 }
 
 // Button callbacks
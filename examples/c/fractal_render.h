@@ -0,0 +1,553 @@
+// Fractal rendering module for the fractal explorer.
+//
+// Computes Mandelbrot iteration counts for a rectangle of pixels:
+//   - vector kernels: 4 doubles per step with AVX, 2 with SSE2 (also used by
+//     Emscripten when built with -msimd128 -msse2), scalar fallback otherwise
+//   - every lane stops counting as soon as it escapes; the loop ends when all
+//     lanes are done
+//   - periodicity checking: orbits that fall into a cycle are classified as
+//     inside the set early instead of running to max_iterations
+//   - the rectangle is split into tiles that run on a small pthread pool when
+//     threads are available (emcc -pthread), and on the caller otherwise
+//   - FractalCache keeps the last iteration field and only computes what a
+//     view change actually exposes, and reports what changed so a colored
+//     image can be updated the same way
+#ifndef FRACTAL_RENDER_H
+#define FRACTAL_RENDER_H
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __EMSCRIPTEN__
+#include <emscripten.h>
+#else
+#include <time.h>
+#endif
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define FRACTAL_LANES 4
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define FRACTAL_LANES 2
+#else
+#define FRACTAL_LANES 1
+#endif
+
+#if defined(__EMSCRIPTEN_PTHREADS__) || defined(FRACTAL_USE_PTHREADS)
+#include <pthread.h>
+#include <stdatomic.h>
+#define FRACTAL_THREADED 1
+#ifndef FRACTAL_THREAD_COUNT
+#define FRACTAL_THREAD_COUNT 4
+#endif
+#else
+#define FRACTAL_THREADED 0
+#endif
+
+#define FRACTAL_TILE_SIZE 32
+
+typedef struct {
+    double center_x;
+    double center_y;
+    double scale;           // complex-plane units per pixel
+    int width;              // image size in pixels
+    int height;
+    int max_iterations;
+} FractalView;
+
+// Complex coordinate of pixel (px, py); the view center sits at (width/2, height/2).
+static inline double fractal_pixel_re(const FractalView* view, double px) {
+    return view->center_x + (px - view->width * 0.5) * view->scale;
+}
+
+static inline double fractal_pixel_im(const FractalView* view, double py) {
+    return view->center_y + (py - view->height * 0.5) * view->scale;
+}
+
+// Iterations before |z| exceeds 2, or max_iter for points in the set.
+static int fractal_iterate(double cr, double ci, int max_iter) {
+    double zr = 0, zi = 0, zr2 = 0, zi2 = 0;
+    double old_r = 0, old_i = 0;
+    int period = 0, check = 8;
+    int i;
+
+    for (i = 0; i < max_iter; i++) {
+        zi = 2 * zr * zi + ci;
+        zr = zr2 - zi2 + cr;
+        zr2 = zr * zr;
+        zi2 = zi * zi;
+
+        if (zr2 + zi2 > 4)
+            return i;
+
+        // Brent-style cycle detection: compare against a saved orbit point
+        // and re-save it at doubling intervals.
+        if (zr == old_r && zi == old_i)
+            return max_iter;
+        if (++period == check) {
+            period = 0;
+            check *= 2;
+            old_r = zr;
+            old_i = zi;
+        }
+    }
+    return max_iter;
+}
+
+#if FRACTAL_LANES == 4
+static void fractal_iterate_lanes(const double* cr_in, double ci_in, int max_iter, int* out) {
+    __m256d cr = _mm256_loadu_pd(cr_in);
+    __m256d ci = _mm256_set1_pd(ci_in);
+    __m256d zr = _mm256_setzero_pd(), zi = _mm256_setzero_pd();
+    __m256d zr2 = _mm256_setzero_pd(), zi2 = _mm256_setzero_pd();
+    __m256d old_r = zr, old_i = zi;
+    __m256d count = _mm256_setzero_pd();
+    __m256d one = _mm256_set1_pd(1.0), four = _mm256_set1_pd(4.0);
+    __m256d limit = _mm256_set1_pd((double)max_iter);
+    __m256d active = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+    int period = 0, check = 8;
+
+    for (int i = 0; i < max_iter; i++) {
+        __m256d zrzi = _mm256_mul_pd(zr, zi);
+        zi = _mm256_add_pd(_mm256_add_pd(zrzi, zrzi), ci);
+        zr = _mm256_add_pd(_mm256_sub_pd(zr2, zi2), cr);
+        zr2 = _mm256_mul_pd(zr, zr);
+        zi2 = _mm256_mul_pd(zi, zi);
+
+        __m256d escaped = _mm256_cmp_pd(_mm256_add_pd(zr2, zi2), four, _CMP_GT_OQ);
+        active = _mm256_andnot_pd(escaped, active);
+        count = _mm256_add_pd(count, _mm256_and_pd(one, active));
+
+        __m256d cycled = _mm256_and_pd(active, _mm256_and_pd(
+            _mm256_cmp_pd(zr, old_r, _CMP_EQ_OQ), _mm256_cmp_pd(zi, old_i, _CMP_EQ_OQ)));
+        if (_mm256_movemask_pd(cycled)) {
+            count = _mm256_blendv_pd(count, limit, cycled);
+            active = _mm256_andnot_pd(cycled, active);
+        }
+        if (_mm256_movemask_pd(active) == 0)
+            break;
+
+        if (++period == check) {
+            period = 0;
+            check *= 2;
+            old_r = zr;
+            old_i = zi;
+        }
+    }
+
+    double counts[4];
+    _mm256_storeu_pd(counts, count);
+    for (int k = 0; k < 4; k++)
+        out[k] = (int)counts[k];
+}
+#elif FRACTAL_LANES == 2
+static void fractal_iterate_lanes(const double* cr_in, double ci_in, int max_iter, int* out) {
+    __m128d cr = _mm_loadu_pd(cr_in);
+    __m128d ci = _mm_set1_pd(ci_in);
+    __m128d zr = _mm_setzero_pd(), zi = _mm_setzero_pd();
+    __m128d zr2 = _mm_setzero_pd(), zi2 = _mm_setzero_pd();
+    __m128d old_r = zr, old_i = zi;
+    __m128d count = _mm_setzero_pd();
+    __m128d one = _mm_set1_pd(1.0), four = _mm_set1_pd(4.0);
+    __m128d limit = _mm_set1_pd((double)max_iter);
+    __m128d active = _mm_castsi128_pd(_mm_set1_epi32(-1));
+    int period = 0, check = 8;
+
+    for (int i = 0; i < max_iter; i++) {
+        __m128d zrzi = _mm_mul_pd(zr, zi);
+        zi = _mm_add_pd(_mm_add_pd(zrzi, zrzi), ci);
+        zr = _mm_add_pd(_mm_sub_pd(zr2, zi2), cr);
+        zr2 = _mm_mul_pd(zr, zr);
+        zi2 = _mm_mul_pd(zi, zi);
+
+        __m128d escaped = _mm_cmpgt_pd(_mm_add_pd(zr2, zi2), four);
+        active = _mm_andnot_pd(escaped, active);
+        count = _mm_add_pd(count, _mm_and_pd(one, active));
+
+        __m128d cycled = _mm_and_pd(active, _mm_and_pd(
+            _mm_cmpeq_pd(zr, old_r), _mm_cmpeq_pd(zi, old_i)));
+        if (_mm_movemask_pd(cycled)) {
+            count = _mm_or_pd(_mm_andnot_pd(cycled, count), _mm_and_pd(cycled, limit));
+            active = _mm_andnot_pd(cycled, active);
+        }
+        if (_mm_movemask_pd(active) == 0)
+            break;
+
+        if (++period == check) {
+            period = 0;
+            check *= 2;
+            old_r = zr;
+            old_i = zi;
+        }
+    }
+
+    double counts[2];
+    _mm_storeu_pd(counts, count);
+    out[0] = (int)counts[0];
+    out[1] = (int)counts[1];
+}
+#endif
+
+// Fills iters (row stride view->width) for pixels in [x0, x1) x [y0, y1).
+static void fractal_compute_rect(const FractalView* view, int* iters,
+                                 int x0, int y0, int x1, int y1) {
+    for (int py = y0; py < y1; py++) {
+        double ci = fractal_pixel_im(view, py);
+        int* row = iters + py * view->width;
+        int px = x0;
+#if FRACTAL_LANES > 1
+        double cr[FRACTAL_LANES];
+        for (; px + FRACTAL_LANES <= x1; px += FRACTAL_LANES) {
+            for (int k = 0; k < FRACTAL_LANES; k++)
+                cr[k] = fractal_pixel_re(view, px + k);
+            fractal_iterate_lanes(cr, ci, view->max_iterations, row + px);
+        }
+#endif
+        for (; px < x1; px++)
+            row[px] = fractal_iterate(fractal_pixel_re(view, px), ci, view->max_iterations);
+    }
+}
+
+#if FRACTAL_THREADED
+// One job at a time: the render thread publishes it, workers and the render
+// thread claim tiles until none are left.
+//
+// A worker can still be inside a claim when its job finishes and the next
+// one is published. Claims therefore carry the job's generation in the top
+// 32 bits and the next tile in the bottom 32, and are taken with a
+// compare-and-swap: a claim made for an old job no longer matches and fails,
+// so it can neither take a tile of the new job with the old job's
+// parameters nor count towards the new job's completion.
+typedef struct {
+    unsigned generation;
+    const FractalView* view;
+    int* iters;
+    int x0, y0, x1, y1;
+    int tiles_x;
+    int tile_count;
+} FractalJob;
+
+static struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    int started;
+    FractalJob job;                 // guarded by mutex
+    atomic_uint_least64_t claim;    // generation << 32 | next tile
+    atomic_int tiles_done;
+} fractal_pool = {
+    .mutex = PTHREAD_MUTEX_INITIALIZER,
+    .wake = PTHREAD_COND_INITIALIZER,
+    .started = 0,
+    .job = { .generation = 0, .view = NULL, .iters = NULL,
+             .x0 = 0, .y0 = 0, .x1 = 0, .y1 = 0, .tiles_x = 0, .tile_count = 0 },
+    .claim = 0,
+    .tiles_done = 0,
+};
+
+static void fractal_run_tiles(const FractalJob* job) {
+    uint64_t claim = atomic_load(&fractal_pool.claim);
+    for (;;) {
+        if ((unsigned)(claim >> 32) != job->generation)
+            return;
+        int tile = (int)(uint32_t)claim;
+        if (tile >= job->tile_count)
+            return;
+        // On failure claim is reloaded and checked again.
+        if (!atomic_compare_exchange_weak(&fractal_pool.claim, &claim, claim + 1))
+            continue;
+
+        int tx = job->x0 + (tile % job->tiles_x) * FRACTAL_TILE_SIZE;
+        int ty = job->y0 + (tile / job->tiles_x) * FRACTAL_TILE_SIZE;
+        int tx1 = tx + FRACTAL_TILE_SIZE < job->x1 ? tx + FRACTAL_TILE_SIZE : job->x1;
+        int ty1 = ty + FRACTAL_TILE_SIZE < job->y1 ? ty + FRACTAL_TILE_SIZE : job->y1;
+        fractal_compute_rect(job->view, job->iters, tx, ty, tx1, ty1);
+        atomic_fetch_add(&fractal_pool.tiles_done, 1);
+        claim = atomic_load(&fractal_pool.claim);
+    }
+}
+
+static void* fractal_worker(void* arg) {
+    (void)arg;
+    unsigned seen = 0;
+    for (;;) {
+        pthread_mutex_lock(&fractal_pool.mutex);
+        while (fractal_pool.job.generation == seen)
+            pthread_cond_wait(&fractal_pool.wake, &fractal_pool.mutex);
+        FractalJob job = fractal_pool.job;
+        pthread_mutex_unlock(&fractal_pool.mutex);
+        seen = job.generation;
+        fractal_run_tiles(&job);
+    }
+    return NULL;
+}
+#endif
+
+// Same as fractal_compute_rect, split into tiles and spread over all threads.
+static void fractal_compute_parallel(const FractalView* view, int* iters,
+                                     int x0, int y0, int x1, int y1) {
+    if (x1 <= x0 || y1 <= y0) return;
+#if FRACTAL_THREADED
+    if (!fractal_pool.started) {
+        fractal_pool.started = 1;
+        for (int i = 0; i < FRACTAL_THREAD_COUNT - 1; i++) {
+            pthread_t thread;
+            pthread_create(&thread, NULL, fractal_worker, NULL);
+            pthread_detach(thread);
+        }
+    }
+
+    FractalJob job;
+    job.view = view;
+    job.iters = iters;
+    job.x0 = x0;
+    job.y0 = y0;
+    job.x1 = x1;
+    job.y1 = y1;
+    job.tiles_x = (x1 - x0 + FRACTAL_TILE_SIZE - 1) / FRACTAL_TILE_SIZE;
+    job.tile_count = job.tiles_x * ((y1 - y0 + FRACTAL_TILE_SIZE - 1) / FRACTAL_TILE_SIZE);
+
+    pthread_mutex_lock(&fractal_pool.mutex);
+    // Generation 0 is what idle workers start out having seen.
+    job.generation = fractal_pool.job.generation + 1;
+    if (job.generation == 0)
+        job.generation = 1;
+    fractal_pool.job = job;
+    // The previous job's tiles are all counted by now, and stale claims
+    // cannot succeed, so nothing else touches tiles_done until the new
+    // generation is published below.
+    atomic_store(&fractal_pool.tiles_done, 0);
+    atomic_store(&fractal_pool.claim, (uint64_t)job.generation << 32);
+    pthread_cond_broadcast(&fractal_pool.wake);
+    pthread_mutex_unlock(&fractal_pool.mutex);
+
+    fractal_run_tiles(&job);
+    // The main browser thread must not block on a condition variable; the
+    // remaining tiles are already running, so a short spin is enough.
+    while (atomic_load(&fractal_pool.tiles_done) < job.tile_count) {
+    }
+#else
+    fractal_compute_rect(view, iters, x0, y0, x1, y1);
+#endif
+}
+
+// Milliseconds from a monotonic clock.
+static double fractal_now_ms(void) {
+#ifdef __EMSCRIPTEN__
+    return emscripten_get_now();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1e6;
+#endif
+}
+
+// Iteration field for the last rendered view. Both buffers are supplied by
+// the caller and must hold at least capacity counts.
+//   - unchanged view: nothing is computed
+//   - pan by whole pixels: the field is shifted in place and only the
+//     exposed strips are computed
+//   - anything else (zoom, resize, new iteration limit): the old field is
+//     resampled as a preview, then recomputed band by band over the next
+//     updates within the time budget
+//
+// After each update, changed_all says every count may differ. Otherwise the
+// field moved by (moved_x, moved_y) like fractal_shift_pixels does, then the
+// strips that uncovered and rows [dirty_y0, dirty_y1) were recomputed.
+typedef struct {
+    FractalView view;       // view the field describes
+    int* iters;
+    int* scratch;
+    int capacity;
+    int valid;
+    int pending_y0;         // rows [pending_y0, pending_y1) still hold preview data
+    int pending_y1;
+    int changed_all;        // changes made by the last update
+    int moved_x, moved_y;
+    int dirty_y0, dirty_y1;
+} FractalCache;
+
+#define FRACTAL_SNAP_TOLERANCE 0.01     // pixels
+
+static void fractal_cache_init(FractalCache* cache, int* iters, int* scratch, int capacity) {
+    memset(cache, 0, sizeof(*cache));
+    cache->iters = iters;
+    cache->scratch = scratch;
+    cache->capacity = capacity;
+}
+
+// Moves a w x h image of 4-byte pixels so that pixel (x, y) shows what
+// pixel (x + dx, y + dy) showed. The strips left uncovered keep stale data.
+// |dx| < w and |dy| < h.
+static void fractal_shift_pixels(void* pixels, int w, int h, int dx, int dy) {
+    int32_t* data = (int32_t*)pixels;
+    int src_y = dy > 0 ? dy : 0, dst_y = dy > 0 ? 0 : -dy;
+    int src_x = dx > 0 ? dx : 0, dst_x = dx > 0 ? 0 : -dx;
+    int rows = h - (dy > 0 ? dy : -dy);
+    int cols = w - (dx > 0 ? dx : -dx);
+
+    if (dy == 0) {
+        for (int y = 0; y < h; y++) {
+            memmove(data + y * w + dst_x, data + y * w + src_x, cols * sizeof(int32_t));
+        }
+    } else if (dx == 0) {
+        memmove(data + dst_y * w, data + src_y * w, (size_t)rows * w * sizeof(int32_t));
+    } else {
+        // Walk rows away from the overlap so no source row is overwritten first.
+        for (int i = 0; i < rows; i++) {
+            int r = dy > 0 ? i : rows - 1 - i;
+            memmove(data + (dst_y + r) * w + dst_x, data + (src_y + r) * w + src_x,
+                    cols * sizeof(int32_t));
+        }
+    }
+}
+
+// Moves the field by (dx, dy) pixels and computes the uncovered strips.
+static void fractal_cache_shift(FractalCache* cache, int dx, int dy) {
+    const FractalView* view = &cache->view;
+    int w = view->width, h = view->height;
+    int* iters = cache->iters;
+
+    if (dx <= -w || dx >= w || dy <= -h || dy >= h) {
+        fractal_compute_parallel(view, iters, 0, 0, w, h);
+        cache->pending_y0 = cache->pending_y1 = 0;
+        cache->changed_all = 1;
+        return;
+    }
+
+    // Content moves opposite to the view: row y shows what row y + dy showed.
+    fractal_shift_pixels(iters, w, h, dx, dy);
+    cache->moved_x = dx;
+    cache->moved_y = dy;
+    int dst_y = dy > 0 ? 0 : -dy;
+    int rows = h - (dy > 0 ? dy : -dy);
+    int cols = w - (dx > 0 ? dx : -dx);
+
+    // Preview rows travel with the content.
+    if (cache->pending_y0 < cache->pending_y1) {
+        int y0 = cache->pending_y0 - dy, y1 = cache->pending_y1 - dy;
+        cache->pending_y0 = y0 < 0 ? 0 : y0;
+        cache->pending_y1 = y1 > h ? h : y1;
+        if (cache->pending_y0 >= cache->pending_y1)
+            cache->pending_y0 = cache->pending_y1 = 0;
+    }
+
+    if (dy > 0)
+        fractal_compute_parallel(view, iters, 0, rows, w, h);
+    else if (dy < 0)
+        fractal_compute_parallel(view, iters, 0, 0, w, -dy);
+    if (dx > 0)
+        fractal_compute_parallel(view, iters, cols, dst_y, w, dst_y + rows);
+    else if (dx < 0)
+        fractal_compute_parallel(view, iters, 0, dst_y, -dx, dst_y + rows);
+}
+
+// Nearest-neighbour resample of the old field into the new view, clamped at
+// the old field's edges. Counts are limited to the new iteration limit.
+static void fractal_cache_resample(FractalCache* cache, const FractalView* view) {
+    const FractalView* old = &cache->view;
+    int w = view->width, h = view->height;
+    int old_max = old->max_iterations, new_max = view->max_iterations;
+    int columns[w];
+
+    for (int x = 0; x < w; x++) {
+        int ox = (int)floor((fractal_pixel_re(view, x) - old->center_x) / old->scale + old->width * 0.5 + 0.5);
+        columns[x] = ox < 0 ? 0 : (ox >= old->width ? old->width - 1 : ox);
+    }
+    for (int y = 0; y < h; y++) {
+        int oy = (int)floor((fractal_pixel_im(view, y) - old->center_y) / old->scale + old->height * 0.5 + 0.5);
+        oy = oy < 0 ? 0 : (oy >= old->height ? old->height - 1 : oy);
+        const int* src = cache->iters + oy * old->width;
+        int* dst = cache->scratch + y * w;
+        for (int x = 0; x < w; x++) {
+            int n = src[columns[x]];
+            dst[x] = (n >= old_max || n > new_max) ? new_max : n;
+        }
+    }
+
+    int* swap = cache->iters;
+    cache->iters = cache->scratch;
+    cache->scratch = swap;
+}
+
+// Brings the field up to date with view. Returns 1 when any count changed.
+// budget_ms bounds the time spent refining preview rows in this call.
+static int fractal_cache_update(FractalCache* cache, const FractalView* view, double budget_ms) {
+    double start = fractal_now_ms();
+    const FractalView* old = &cache->view;
+    int changed = 0;
+
+    cache->changed_all = 0;
+    cache->moved_x = cache->moved_y = 0;
+    cache->dirty_y0 = cache->dirty_y1 = 0;
+
+    if (view->width * view->height > cache->capacity)
+        return 0;
+
+    if (!cache->valid) {
+        cache->view = *view;
+        fractal_compute_parallel(view, cache->iters, 0, 0, view->width, view->height);
+        cache->valid = 1;
+        cache->pending_y0 = cache->pending_y1 = 0;
+        cache->changed_all = 1;
+        return 1;
+    }
+
+    // Same pixel grid, moved by a whole number of pixels?
+    double sx = (view->center_x - old->center_x) / view->scale;
+    double sy = (view->center_y - old->center_y) / view->scale;
+    double dx = floor(sx + 0.5), dy = floor(sy + 0.5);
+    int same_grid = view->scale == old->scale && view->width == old->width &&
+                    view->height == old->height &&
+                    fabs(sx - dx) <= FRACTAL_SNAP_TOLERANCE &&
+                    fabs(sy - dy) <= FRACTAL_SNAP_TOLERANCE;
+
+    if (same_grid && view->max_iterations == old->max_iterations) {
+        if (dx != 0 || dy != 0) {
+            // Keep the field anchored on the pixel grid so rounding never
+            // accumulates across pans.
+            cache->view.center_x += dx * view->scale;
+            cache->view.center_y += dy * view->scale;
+            fractal_cache_shift(cache, (int)dx, (int)dy);
+            changed = 1;
+        }
+    } else if (same_grid && dx == 0 && dy == 0 &&
+               view->max_iterations < old->max_iterations) {
+        // Escape counts below the new limit are still exact.
+        int limit = view->max_iterations, count = view->width * view->height;
+        for (int i = 0; i < count; i++) {
+            if (cache->iters[i] > limit)
+                cache->iters[i] = limit;
+        }
+        cache->view.max_iterations = limit;
+        cache->changed_all = 1;
+        changed = 1;
+    } else {
+        fractal_cache_resample(cache, view);
+        cache->view = *view;
+        cache->pending_y0 = 0;
+        cache->pending_y1 = view->height;
+        cache->changed_all = 1;
+        changed = 1;
+    }
+
+    // Refine preview rows a band at a time until the budget runs out.
+    while (cache->pending_y0 < cache->pending_y1) {
+        int y1 = cache->pending_y0 + FRACTAL_TILE_SIZE;
+        if (y1 > cache->pending_y1) y1 = cache->pending_y1;
+        fractal_compute_parallel(&cache->view, cache->iters, 0, cache->pending_y0,
+                                 cache->view.width, y1);
+        // Bands are refined top to bottom, so they form one run of rows.
+        if (cache->dirty_y0 == cache->dirty_y1)
+            cache->dirty_y0 = cache->pending_y0;
+        cache->dirty_y1 = y1;
+        cache->pending_y0 = y1;
+        changed = 1;
+        if (fractal_now_ms() - start >= budget_ms)
+            break;
+    }
+    return changed;
+}
+
+#endif // FRACTAL_RENDER_H
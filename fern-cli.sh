@@ -457,9 +457,13 @@ compile_app() {
     else
         echo -e "${YELLOW}Compiling $source_file with C implementation...${NC}"
         
-        # Original C compilation command
+        # Wasm SIMD, with SSE2 intrinsics mapped onto it, lets vectorized
+        # code such as the fractal explorer's kernel run vectorized. Builds
+        # stay single-threaded: -pthread needs a cross-origin isolated page,
+        # which the development server does not provide.
         emcc "$source_file" -o "$dist_dir/${output_base}.html" --shell-file template.html \
             $std_flag $include_path \
+            -msimd128 -msse2 \
             -s WASM=1 \
             -s EXPORTED_RUNTIME_METHODS=['cwrap','HEAPU8'] \
             -s ALLOW_MEMORY_GROWTH=1
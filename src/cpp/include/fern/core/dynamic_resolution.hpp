@@ -0,0 +1,42 @@
+#pragma once
+
+namespace Fern {
+    enum class UpscaleFilter {
+        Nearest,
+        Bilinear
+    };
+
+    // Frame-time driven resolution scaling.
+    //
+    // While enabled, the draw callback renders into a reduced-resolution
+    // internal canvas whenever frames run over budget (75%, then 50% of the
+    // presented size), and the result is upscaled into the presented buffer
+    // before widgets are drawn at full resolution on top. When frames have
+    // enough headroom again the scale steps back up. Changes wait for the
+    // frame time to settle, so the scale does not oscillate around the budget.
+    //
+    // Scene code must size itself from globalCanvas->getWidth() / getHeight(),
+    // which report the internal canvas while it is active. Input stays in
+    // presented coordinates.
+    class DynamicResolution {
+    public:
+        static void setEnabled(bool enabled);
+        static bool isEnabled();
+
+        // Frame time to stay under, in milliseconds (default 1000 / 60).
+        static void setTargetFrameTime(double milliseconds);
+        static void setMinimumScale(float scale);
+        static void setFilter(UpscaleFilter filter);
+
+        // Scale of the internal canvas, 1.0 when rendering at full resolution.
+        static float getScale();
+
+        // Render loop hooks. beginFrame() redirects drawing to the internal
+        // canvas if the scale is below 1, endFrame() upscales it into the
+        // presented canvas and restores it. recordFrameTime() feeds the
+        // measured frame time back into the scale choice.
+        static void beginFrame();
+        static void endFrame();
+        static void recordFrameTime(double milliseconds);
+    };
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "types.hpp"
+#include <cstddef>
+#include <vector>
 
 namespace Fern {
     class Input {
@@ -8,10 +10,58 @@ namespace Fern {
         static InputState& getState();
         static void resetEvents();
         
+        // Moves everything queued by the producer into this frame's batch and
+        // applies it to the state. Called once per frame by the render loop.
+        static void pollEvents();
+        
+        // Changes recorded for this frame, oldest first. Updates that leave
+        // the state untouched (same position, same button) produce no event.
+        static const std::vector<InputEvent>& getEvents();
+        static bool hasEvents() { return !events_.empty(); }
+        
+        // Producer side. Events are timestamped and pushed into a lock-free
+        // ring, so these may be called from one thread other than the frame
+        // loop (browser callbacks or a native input thread) and never block.
         static void updateMousePosition(int x, int y);
         static void updateMouseButton(bool down);
         
+        // Events lost because the ring was full when they arrived.
+        static size_t getDroppedEventCount();
+        
+        // Collapses each run of consecutive Move events to the latest one,
+        // for consumers that only care where the pointer ended up.
+        static void coalesceMoves(std::vector<InputEvent>& events);
+        
+        // Calls fn(from, to) for every pointer segment travelled with the
+        // button held during this frame, so strokes follow the full path
+        // instead of jumping between per-frame positions.
+        template <typename Fn>
+        static void forEachDragSegment(Fn&& fn) {
+            bool down = frameStart_.mouseDown;
+            Point last(frameStart_.mouseX, frameStart_.mouseY);
+            for (const InputEvent& event : events_) {
+                Point point(event.x, event.y);
+                switch (event.type) {
+                    case InputEventType::Move:
+                        if (down) fn(last, point);
+                        last = point;
+                        break;
+                    case InputEventType::Down:
+                        down = true;
+                        last = point;
+                        break;
+                    case InputEventType::Up:
+                        down = false;
+                        break;
+                    case InputEventType::Click:
+                        break;
+                }
+            }
+        }
+        
     private:
         static InputState state_;
+        static InputState frameStart_;
+        static std::vector<InputEvent> events_;
     };
-}
\ No newline at end of file
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Fern {
+    // Interaction rules in the style of "particle life": every pair of
+    // particles within interactionRadius pushes or pulls according to the
+    // attraction between their types, peaking halfway across the radius.
+    struct ParticleRules {
+        int typeCount = 1;
+        // attraction[a * typeCount + b]: how strongly type a is drawn to
+        // type b, from -1 (repulsion) to 1 (attraction).
+        std::vector<float> attraction = std::vector<float>(1, 0.0f);
+
+        float interactionRadius = 80.0f;
+        float minDistance = 5.0f;       // closer pairs always repel
+        float forceStrength = 0.5f;
+        float friction = 0.1f;
+        float maxSpeed = 3.0f;
+
+        // Wrap-around world, or walls that bounce particles back inside
+        // a margin.
+        bool wrapEdges = true;
+        float wallMargin = 0.0f;
+        float wallBounce = 0.8f;
+    };
+
+    // Particle system stored as a structure of arrays.
+    //
+    // - Each step sorts the particles into a uniform grid whose cells are at
+    //   least interactionRadius wide, so neighbors are found in the 3x3 block
+    //   of cells around a particle instead of by testing every pair.
+    // - Sorting reorders the arrays by cell, so each neighbor cell is a
+    //   contiguous run that the force kernel walks four particles at a time.
+    // - Forces for all particles are computed from the same snapshot of
+    //   positions and then applied, so chunks of particles run in parallel.
+    //
+    // Particle indices are not stable across step(); use the arrays right
+    // after stepping to draw.
+    class ParticleSystem {
+    public:
+        ParticleSystem(float worldWidth, float worldHeight);
+
+        void setRules(const ParticleRules& rules);
+        const ParticleRules& getRules() const { return rules_; }
+        void setAttraction(int type, int otherType, float value);
+        void resize(float worldWidth, float worldHeight);
+
+        void add(float x, float y, float vx, float vy, int type, float size = 3.0f);
+        void clear();
+        void reserve(size_t count);
+        size_t size() const { return x_.size(); }
+
+        // Advances the simulation by one tick.
+        void step();
+
+        const float* positionsX() const { return x_.data(); }
+        const float* positionsY() const { return y_.data(); }
+        const float* velocitiesX() const { return vx_.data(); }
+        const float* velocitiesY() const { return vy_.data(); }
+        const int* types() const { return type_.data(); }
+        const float* sizes() const { return size_.data(); }
+
+    private:
+        void buildGrid();
+        void computeForces(size_t begin, size_t end);
+        void integrate(size_t begin, size_t end);
+
+        ParticleRules rules_;
+        float worldWidth_;
+        float worldHeight_;
+
+        std::vector<float> x_, y_, vx_, vy_, size_;
+        std::vector<int> type_;
+        std::vector<float> fx_, fy_;
+
+        // Grid: particles of cell c are [cellStart_[c], cellStart_[c + 1])
+        // after sorting; neighbors_ holds up to 9 distinct cells per cell.
+        int columns_ = 0;
+        int rows_ = 0;
+        std::vector<uint32_t> cellStart_;
+        std::vector<int> neighbors_;
+        std::vector<uint8_t> neighborCount_;
+        std::vector<uint32_t> cellOf_;
+        std::vector<uint32_t> order_;
+        std::vector<float> scratch_;
+        std::vector<int> scratchTypes_;
+    };
+}
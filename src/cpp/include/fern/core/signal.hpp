@@ -1,35 +1,526 @@
 #pragma once
 
+#include "signal_queue.hpp"
+#include <atomic>
 #include <functional>
+#include <memory>
+#include <tuple>
 #include <vector>
 #include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 namespace Fern
 {
+    template <typename... Args>
+    class Signal;
+
+    // Handle to one connection, returned by Signal::connect(). It is a
+    // class rather than an integer so that it cannot be narrowed into a
+    // 32-bit size_t or int by accident. Default-constructed IDs refer to
+    // no connection.
+    class ConnectionID {
+    public:
+        ConnectionID() = default;
+
+        bool operator==(const ConnectionID& other) const {
+            return index_ == other.index_ && generation_ == other.generation_;
+        }
+        bool operator!=(const ConnectionID& other) const { return !(*this == other); }
+
+    private:
+        template <typename... Args>
+        friend class Signal;
+
+        ConnectionID(uint32_t index, uint32_t generation) : index_(index), generation_(generation) {}
+
+        uint32_t index_ = UINT32_MAX;
+        uint32_t generation_ = 0;       // slot generations start at 1
+    };
+
+    // Multicast callback list.
+    //
+    // - Slots are type-erased in place: callables up to SLOT_STORAGE bytes are
+    //   stored inside the slot, and the first INLINE_SLOTS slots live inside
+    //   the Signal itself, so connecting a small lambda does not allocate.
+    // - Connection IDs carry a slot index and a generation, so disconnect is
+    //   O(1) and a stale ID can never remove a newer connection.
+    // - emit() passes arguments by reference to every slot; nothing is copied
+    //   unless a slot takes its parameter by value. Every slot sees the same
+    //   argument, so none may move from it: move-only types can be emitted
+    //   and posted, but slots must take them by const reference.
+    // - Slots may connect or disconnect (themselves included) while the signal
+    //   is emitting. Removals are deferred until the outermost emit returns,
+    //   and slots connected during an emission are first called by the next one.
+    // - post() queues an emission from any thread; the render loop delivers it
+    //   on the render thread through SignalQueue, optionally coalesced. Queued
+    //   emissions live in a fixed pool per signal and are reused, so posting
+    //   does not allocate.
     template <typename... Args>
     class Signal{
-    public: 
-        using ConnectionID = size_t;
+        // Value parameters are received as const&, reference parameters as-is.
+        template <typename T>
+        using Param = typename std::conditional<std::is_reference<T>::value, T, const T&>::type;
+
+        static constexpr size_t SLOT_STORAGE = 4 * sizeof(void*);
+        // Undelivered posts one signal can hold: a producer at 15 kHz
+        // against a 60 Hz render loop. Faster producers need reservePosts()
+        // or coalescing, which holds one pending emission however often the
+        // signal is posted.
+        static constexpr uint32_t DEFAULT_POST_CAPACITY = 256;
+        static constexpr uint32_t INLINE_SLOTS = 2;
+        static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+        using Storage = typename std::aligned_storage<SLOT_STORAGE, alignof(std::max_align_t)>::type;
+
+        // relocate() move-constructs into dst and leaves src empty, so it
+        // needs no destroy() afterwards.
+        struct Ops {
+            void (*invoke)(Storage& storage, Param<Args>... args);
+            void (*relocate)(Storage& dst, Storage& src);
+            void (*copy)(Storage& dst, const Storage& src);
+            void (*destroy)(Storage& storage);
+        };
+
+        template <typename F>
+        struct InlineOps {
+            static F& get(Storage& s) { return *reinterpret_cast<F*>(&s); }
+            static const F& get(const Storage& s) { return *reinterpret_cast<const F*>(&s); }
+            template <typename G>
+            static void construct(Storage& s, G&& fn) { new (&s) F(std::forward<G>(fn)); }
+            static void invoke(Storage& s, Param<Args>... args) { get(s)(args...); }
+            static void relocate(Storage& dst, Storage& src) {
+                new (&dst) F(std::move(get(src)));
+                get(src).~F();
+            }
+            static void copy(Storage& dst, const Storage& src) { new (&dst) F(get(src)); }
+            static void destroy(Storage& s) { get(s).~F(); }
+            static const Ops ops;
+        };
+
+        template <typename F>
+        struct HeapOps {
+            static F*& get(Storage& s) { return *reinterpret_cast<F**>(&s); }
+            static F* get(const Storage& s) { return *reinterpret_cast<F* const*>(&s); }
+            template <typename G>
+            static void construct(Storage& s, G&& fn) { new (&s) F*(new F(std::forward<G>(fn))); }
+            static void invoke(Storage& s, Param<Args>... args) { (*get(s))(args...); }
+            static void relocate(Storage& dst, Storage& src) {
+                new (&dst) F*(get(src));
+                get(src) = nullptr;
+            }
+            static void copy(Storage& dst, const Storage& src) { new (&dst) F*(new F(*get(src))); }
+            static void destroy(Storage& s) { delete get(s); }
+            static const Ops ops;
+        };
+
+        template <typename F>
+        using OpsFor = typename std::conditional<
+            sizeof(F) <= SLOT_STORAGE && alignof(F) <= alignof(std::max_align_t) &&
+                std::is_nothrow_move_constructible<F>::value,
+            InlineOps<F>, HeapOps<F>>::type;
+
+        struct Slot {
+            const Ops* ops = nullptr;       // set while a callable is stored
+            bool live = false;              // false once disconnected
+            uint32_t generation = 1;
+            uint32_t nextFree = NO_SLOT;
+            Storage storage;
+
+            Slot() = default;
+            Slot(Slot&& other) noexcept { take(other); }
+            Slot(const Slot& other) { assign(other); }
+            Slot& operator=(Slot&& other) noexcept {
+                if (this != &other) {
+                    reset();
+                    take(other);
+                }
+                return *this;
+            }
+            Slot& operator=(const Slot& other) {
+                if (this != &other) {
+                    reset();
+                    assign(other);
+                }
+                return *this;
+            }
+            ~Slot() { reset(); }
+
+            void reset() {
+                if (ops) {
+                    ops->destroy(storage);
+                    ops = nullptr;
+                }
+                live = false;
+            }
+
+        private:
+            void take(Slot& other) {
+                ops = other.ops;
+                live = other.live;
+                generation = other.generation;
+                nextFree = other.nextFree;
+                if (ops) {
+                    ops->relocate(storage, other.storage);
+                    other.ops = nullptr;
+                    other.live = false;
+                }
+            }
+            void assign(const Slot& other) {
+                live = other.live;
+                generation = other.generation;
+                nextFree = other.nextFree;
+                if (other.ops && other.live) {
+                    other.ops->copy(storage, other.storage);
+                    ops = other.ops;
+                } else {
+                    live = false;
+                }
+            }
+        };
+
+    public:
+        using ConnectionID = Fern::ConnectionID;
         using SlotFunction = std::function<void(Args...)>;
-        ConnectionID connect(SlotFunction slot) {
-            ConnectionID id = nextID_++;
-            slots_.push_back({id, slot});
-            return id;
+
+        Signal() = default;
+        // Copies the live connections; an in-progress emission is not copied.
+        Signal(const Signal& other) { copyFrom(other); }
+        ~Signal() {
+            SignalQueue::Link* link = link_.load(std::memory_order_acquire);
+            if (link) {
+                link->target = nullptr;
+                link->release();
+            }
+        }
+        Signal& operator=(const Signal& other) {
+            if (this != &other) {
+                for (uint32_t i = 0; i < count_; ++i) {
+                    slotAt(i).reset();
+                }
+                copyFrom(other);
+            }
+            return *this;
         }
-        void emit(Args... args) const {
-            for (const auto& slot: slots_){
-                slot.second(args...);
-            }            
+
+        template <typename F>
+        ConnectionID connect(F&& slot) {
+            using Fn = typename std::decay<F>::type;
+            using FnOps = OpsFor<Fn>;
+
+            uint32_t index;
+            Slot* target;
+            if (emitting_ > 0) {
+                // Storage must not move while slots are running; park the new
+                // slot and give it the index it will occupy after the emission.
+                index = count_ + (uint32_t)pending_.size();
+                pending_.emplace_back();
+                target = &pending_.back();
+            } else if (freeHead_ != NO_SLOT) {
+                index = freeHead_;
+                target = &slotAt(index);
+                freeHead_ = target->nextFree;
+            } else {
+                index = count_++;
+                if (index >= INLINE_SLOTS) {
+                    overflow_.emplace_back();
+                }
+                target = &slotAt(index);
+            }
+
+            FnOps::construct(target->storage, std::forward<F>(slot));
+            target->ops = &FnOps::ops;
+            target->live = true;
+            target->nextFree = NO_SLOT;
+            return ConnectionID(index, target->generation);
         }
+
+        void emit(Param<Args>... args) const {
+            uint32_t count = count_;
+            EmitScope scope(*this);
+            for (uint32_t i = 0; i < count; ++i) {
+                Slot& slot = slotAt(i);
+                if (slot.live) {
+                    slot.ops->invoke(slot.storage, args...);
+                }
+            }
+        }
+
+        // Thread-safe and lock-free. The arguments are copied into the queue
+        // and emit() runs with them on the render thread during the next
+        // frame. The signal must not be destroyed while other threads post.
+        //
+        // Emissions are taken from a pool of reserved ones and returned to it
+        // once delivered; when all are waiting for delivery post() drops the
+        // emission and returns false. A coalescing signal overwrites its one
+        // pending emission instead, so it only runs out when more threads
+        // than the capacity post at the same instant. Nothing is allocated
+        // except by copying the arguments, and by the first post() if
+        // reservePosts() was not called.
+        //
+        // Arguments are taken by value and moved into the queue, so
+        // temporaries and move-only values are not copied.
+        bool post(typename std::decay<Args>::type... args) const {
+            Pool* pool = queuePool(DEFAULT_POST_CAPACITY);
+            uint32_t index = pool->acquire();
+            if (index == NO_SLOT) return false;
+            pool->retain();
+            QueuedEmission* emission =
+                new (&pool->storage[index]) QueuedEmission(pool, index, std::move(args)...);
+            if (!coalesce_.load(std::memory_order_relaxed)) {
+                SignalQueue::push(emission);
+                return true;
+            }
+
+            // Whoever swaps an emission out of latest owns it: the render
+            // thread to deliver it, a later post to discard it.
+            uint32_t previous = pool->latest.exchange(index, std::memory_order_acq_rel);
+            if (previous == NO_SLOT) {
+                pool->retain();
+                SignalQueue::push(&pool->latestNode);
+            } else {
+                pool->emission(previous)->recycle();
+            }
+            return true;
+        }
+
+        // Sets how many posted emissions may wait for delivery at once
+        // (DEFAULT_POST_CAPACITY unless set). Takes effect only before the
+        // first post(); call it on the render thread.
+        void reservePosts(uint32_t capacity) const { queuePool(std::max(capacity, 1u)); }
+
+        // When enabled, several posts queued within one frame deliver only
+        // the most recent one. Call from the render thread.
+        void setCoalescing(bool enabled) { coalesce_.store(enabled, std::memory_order_relaxed); }
+
         void disconnect(ConnectionID id) {
-            slots_.erase(
-                std::remove_if(slots_.begin(), slots_.end(),
-                    [id](const auto& pair) { return pair.first == id; }),
-                slots_.end()
-            );
+            uint32_t index = id.index_;
+            uint32_t generation = id.generation_;
+            uint32_t total = count_ + (uint32_t)pending_.size();
+            if (index >= total) return;
+
+            Slot& slot = slotAt(index);
+            if (!slot.live || slot.generation != generation) return;
+
+            slot.live = false;
+            slot.generation++;
+            if (emitting_ > 0) {
+                // The slot may be the one currently running; destroy it later.
+                deferred_.push_back(index);
+            } else {
+                release(index);
+            }
         }
+
         private:
-            std::vector<std::pair<ConnectionID, SlotFunction>> slots_;
-            ConnectionID nextID_ = 0;
-    };    
+            struct Pool;
+
+            struct QueuedEmission : SignalQueue::Node {
+                std::tuple<typename std::decay<Args>::type...> args;
+                uint32_t index;
+
+                QueuedEmission(Pool* pool, uint32_t i, typename std::decay<Args>::type&&... a)
+                    : args(std::move(a)...), index(i) {
+                    link = pool;
+                }
+
+                const Signal& signal() const { return *static_cast<const Signal*>(link->target); }
+                bool coalesces() const override {
+                    return signal().coalesce_.load(std::memory_order_relaxed);
+                }
+                void deliver() override { deliver(std::index_sequence_for<Args...>()); }
+                // Also called by post() for a superseded coalesced emission.
+                void recycle() override {
+                    Pool* pool = static_cast<Pool*>(link);
+                    uint32_t i = index;
+                    this->~QueuedEmission();
+                    pool->free(i);
+                    pool->release();
+                }
+
+                template <size_t... I>
+                void deliver(std::index_sequence<I...>) { signal().emit(std::get<I>(args)...); }
+            };
+
+            // Queued once per frame for a coalescing signal and delivers
+            // whichever emission is latest when the render thread gets to it.
+            // It is only queued again after deliver() has taken the latest
+            // emission, so it is never in the queue twice.
+            struct LatestNode : SignalQueue::Node {
+                bool coalesces() const override { return false; }
+                void deliver() override {
+                    Pool* pool = static_cast<Pool*>(link);
+                    uint32_t index = pool->latest.exchange(NO_SLOT, std::memory_order_acq_rel);
+                    if (index != NO_SLOT) {
+                        pool->emission(index)->deliver();
+                        pool->emission(index)->recycle();
+                    }
+                }
+                void recycle() override {
+                    Pool* pool = static_cast<Pool*>(link);
+                    if (!pool->target) {
+                        // Dropped with its signal; nothing posts any more.
+                        uint32_t index = pool->latest.exchange(NO_SLOT, std::memory_order_acq_rel);
+                        if (index != NO_SLOT) pool->emission(index)->recycle();
+                    }
+                    pool->release();
+                }
+            };
+
+            // Storage for queued emissions plus a lock-free free list of it.
+            // Any thread may acquire or free. The head packs a free index with
+            // a counter bumped on every change, so a thread that read a stale
+            // head cannot pop it (no ABA).
+            struct Pool : SignalQueue::Link {
+                using Cell = typename std::aligned_storage<sizeof(QueuedEmission),
+                                                           alignof(QueuedEmission)>::type;
+                std::unique_ptr<Cell[]> storage;
+                std::unique_ptr<std::atomic<uint32_t>[]> next;
+                std::atomic<uint64_t> head;
+                // Pending emission of a coalescing signal.
+                std::atomic<uint32_t> latest{NO_SLOT};
+                LatestNode latestNode;
+
+                explicit Pool(uint32_t capacity)
+                    : storage(new Cell[capacity]), next(new std::atomic<uint32_t>[capacity]) {
+                    latestNode.link = this;
+                    for (uint32_t i = 0; i < capacity; ++i) {
+                        next[i].store(i + 1 < capacity ? i + 1 : NO_SLOT, std::memory_order_relaxed);
+                    }
+                    head.store(0, std::memory_order_release);
+                }
+
+                QueuedEmission* emission(uint32_t index) {
+                    return reinterpret_cast<QueuedEmission*>(&storage[index]);
+                }
+
+                uint32_t acquire() {
+                    uint64_t current = head.load(std::memory_order_acquire);
+                    for (;;) {
+                        uint32_t index = (uint32_t)current;
+                        if (index == NO_SLOT) return NO_SLOT;
+                        uint64_t tag = (current >> 32) + 1;
+                        uint64_t replacement = (tag << 32) | next[index].load(std::memory_order_relaxed);
+                        if (head.compare_exchange_weak(current, replacement,
+                                std::memory_order_acquire, std::memory_order_acquire)) {
+                            return index;
+                        }
+                    }
+                }
+
+                void free(uint32_t index) {
+                    uint64_t current = head.load(std::memory_order_relaxed);
+                    for (;;) {
+                        next[index].store((uint32_t)current, std::memory_order_relaxed);
+                        uint64_t replacement = (((current >> 32) + 1) << 32) | index;
+                        if (head.compare_exchange_weak(current, replacement,
+                                std::memory_order_release, std::memory_order_relaxed)) {
+                            return;
+                        }
+                    }
+                }
+            };
+
+            // Created by reservePosts() or the first post(), from whichever
+            // thread gets there first.
+            Pool* queuePool(uint32_t capacity) const {
+                SignalQueue::Link* link = link_.load(std::memory_order_acquire);
+                if (link) return static_cast<Pool*>(link);
+                Pool* created = new Pool(capacity);
+                created->target = this;
+                if (link_.compare_exchange_strong(link, created,
+                        std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    return created;
+                }
+                delete created;
+                return static_cast<Pool*>(link);
+            }
+
+            struct EmitScope {
+                const Signal& signal;
+                explicit EmitScope(const Signal& s) : signal(s) { signal.emitting_++; }
+                ~EmitScope() {
+                    if (--signal.emitting_ == 0 &&
+                        (!signal.pending_.empty() || !signal.deferred_.empty())) {
+                        signal.finishEmission();
+                    }
+                }
+            };
+
+            void copyFrom(const Signal& other) {
+                for (uint32_t i = 0; i < INLINE_SLOTS; ++i) {
+                    inline_[i] = other.inline_[i];
+                }
+                overflow_ = other.overflow_;
+                pending_ = other.pending_;
+                deferred_ = other.deferred_;
+                count_ = other.count_;
+                freeHead_ = other.freeHead_;
+                coalesce_.store(other.coalesce_.load(std::memory_order_relaxed),
+                                std::memory_order_relaxed);
+                finishEmission();
+            }
+
+            Slot& slotAt(uint32_t index) const {
+                if (index < INLINE_SLOTS) return inline_[index];
+                if (index < count_) return overflow_[index - INLINE_SLOTS];
+                return pending_[index - count_];
+            }
+
+            void release(uint32_t index) const {
+                Slot& slot = slotAt(index);
+                slot.reset();
+                slot.nextFree = freeHead_;
+                freeHead_ = index;
+            }
+
+            // Runs once the outermost emit() returns.
+            void finishEmission() const {
+                for (Slot& slot : pending_) {
+                    uint32_t index = count_++;
+                    if (index >= INLINE_SLOTS) {
+                        overflow_.push_back(std::move(slot));
+                    } else {
+                        inline_[index] = std::move(slot);
+                    }
+                }
+                pending_.clear();
+                for (uint32_t index : deferred_) {
+                    release(index);
+                }
+                deferred_.clear();
+            }
+
+            // Mutable so that const emit() can finish deferred bookkeeping.
+            mutable Slot inline_[INLINE_SLOTS];
+            mutable std::vector<Slot> overflow_;
+            mutable std::vector<Slot> pending_;
+            mutable std::vector<uint32_t> deferred_;
+            mutable uint32_t count_ = 0;
+            mutable uint32_t freeHead_ = NO_SLOT;
+            mutable uint32_t emitting_ = 0;
+            mutable std::atomic<SignalQueue::Link*> link_{nullptr};
+            std::atomic<bool> coalesce_{false};
+    };
+
+    template <typename... Args>
+    template <typename F>
+    const typename Signal<Args...>::Ops Signal<Args...>::InlineOps<F>::ops = {
+        &Signal<Args...>::InlineOps<F>::invoke,
+        &Signal<Args...>::InlineOps<F>::relocate,
+        &Signal<Args...>::InlineOps<F>::copy,
+        &Signal<Args...>::InlineOps<F>::destroy
+    };
+
+    template <typename... Args>
+    template <typename F>
+    const typename Signal<Args...>::Ops Signal<Args...>::HeapOps<F>::ops = {
+        &Signal<Args...>::HeapOps<F>::invoke,
+        &Signal<Args...>::HeapOps<F>::relocate,
+        &Signal<Args...>::HeapOps<F>::copy,
+        &Signal<Args...>::HeapOps<F>::destroy
+    };
 } // namespace Fern
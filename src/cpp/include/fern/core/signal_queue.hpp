@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Fern {
+    // Cross-thread delivery for Signal::post(). Any thread may push; the
+    // render loop calls dispatch() once per frame and runs every delivery
+    // queued since the previous frame, in order, on the render thread.
+    class SignalQueue {
+    public:
+        // Shared between a signal and its queued emissions, and owned by
+        // whichever lets go last. The render thread clears target when the
+        // signal is destroyed, so emissions still in flight are dropped
+        // instead of reaching a dead signal.
+        struct Link {
+            std::atomic<int> refs{1};
+            const void* target = nullptr;
+            uint64_t seenInDispatch = 0;    // render thread only, for coalescing
+
+            virtual ~Link() = default;
+            void retain() { refs.fetch_add(1, std::memory_order_relaxed); }
+            void release() {
+                if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    delete this;
+                }
+            }
+        };
+
+        // Queued emission. Nodes are not freed by the queue: once delivered
+        // or dropped they are recycled, which hands them back to their owner.
+        struct Node {
+            Node* next = nullptr;
+            Link* link = nullptr;
+
+            virtual ~Node() = default;
+            // Both run on the render thread, only while link->target is set.
+            virtual bool coalesces() const = 0;
+            virtual void deliver() = 0;
+            // Runs on the render thread; the node must not be used afterwards.
+            virtual void recycle() = 0;
+        };
+
+        // Lock-free; safe from any number of threads.
+        static void push(Node* node);
+
+        // Runs the queued deliveries and returns how many were delivered.
+        // When a signal coalesces, only its latest emission of the batch runs.
+        static size_t dispatch();
+
+    private:
+        static std::atomic<Node*> head_;
+        static uint64_t dispatchCount_;
+    };
+}
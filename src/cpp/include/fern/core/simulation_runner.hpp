@@ -0,0 +1,197 @@
+#pragma once
+
+#include "spsc_queue.hpp"
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#if FERN_THREADS
+#include <thread>
+#endif
+
+namespace Fern {
+    // Steps a simulation at a fixed timestep on its own thread while the
+    // render loop draws, so a slow step delays the next state instead of the
+    // next frame.
+    //
+    // - step(current, next, dt) reads the latest state and writes the
+    //   following one into a separate buffer; the two never alias. next
+    //   still holds an older state, so step must overwrite all of it.
+    // - Finished states are published by swapping buffer indices through one
+    //   atomic, so neither side ever waits for the other. The render side
+    //   always sees the newest complete state; states it had no time to look
+    //   at are skipped.
+    // - The render side keeps the previous state as well, and getAlpha()
+    //   places the current frame between the two for interpolated drawing.
+    // - modify() hands changes (spawning, user edits) to the simulation
+    //   thread, which applies them to the next state it produces.
+    //
+    // Without thread support (browser builds without -pthread) the same steps
+    // run inline when the render side calls acquire().
+    template <typename State>
+    class SimulationRunner {
+    public:
+        using StepFunction = std::function<void(const State& current, State& next, double dt)>;
+        using EditFunction = std::function<void(State& state)>;
+
+        SimulationRunner(const State& initial, StepFunction step, double stepSeconds = 1.0 / 60.0)
+            : step_(std::move(step)), stepSeconds_(stepSeconds) {
+            for (Slot& slot : slots_) {
+                slot.state = initial;
+            }
+        }
+
+        SimulationRunner(const SimulationRunner&) = delete;
+        SimulationRunner& operator=(const SimulationRunner&) = delete;
+        ~SimulationRunner() { stop(); }
+
+        void start() {
+            if (running_.exchange(true)) return;
+            Clock::time_point now = Clock::now();
+            nextStep_ = now + duration(stepSeconds_);
+            for (Slot& slot : slots_) {
+                slot.time = now;
+            }
+#if FERN_THREADS
+            thread_ = std::thread([this] { run(); });
+#endif
+        }
+
+        void stop() {
+            if (!running_.exchange(false)) return;
+#if FERN_THREADS
+            thread_.join();
+#endif
+        }
+
+        bool isRunning() const { return running_.load(); }
+
+        // A paused runner publishes nothing; time spent paused is not
+        // caught up afterwards.
+        void setPaused(bool paused) { paused_.store(paused); }
+        bool isPaused() const { return paused_.load(); }
+
+        // Queues an edit for the simulation thread. Fails when too many edits
+        // are waiting. Call from the render thread.
+        bool modify(EditFunction edit) { return edits_.push(std::move(edit)); }
+
+        // Render side: picks up the newest published state, if there is one.
+        // Call once per frame before current(), previous() or getAlpha().
+        void acquire() {
+#if !FERN_THREADS
+            if (running_.load()) runDueSteps();
+#endif
+            if (ready_.load(std::memory_order_acquire) & NEW_STATE) {
+                uint32_t newest = ready_.exchange(previous_, std::memory_order_acq_rel);
+                previous_ = current_;
+                current_ = newest & SLOT_MASK;
+            }
+        }
+
+        const State& current() const { return slots_[current_].state; }
+        const State& previous() const { return slots_[previous_].state; }
+        uint64_t getStepCount() const { return slots_[current_].step; }
+
+        // Position of "now, one step ago" between previous() and current(),
+        // in [0, 1]. Drawing one step behind keeps a published state on both
+        // sides of the frame, so the motion never has to be extrapolated.
+        float getAlpha() const {
+            const Slot& from = slots_[previous_];
+            const Slot& to = slots_[current_];
+            double span = seconds(to.time - from.time);
+            if (span <= 0.0) return 1.0f;
+            double t = seconds(Clock::now() - from.time) - stepSeconds_;
+            return (float)std::min(std::max(t / span, 0.0), 1.0);
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        static constexpr uint32_t SLOT_MASK = 3;
+        static constexpr uint32_t NEW_STATE = 4;
+        // Steps run back to back at most before the schedule is reset, so a
+        // stall does not turn into a burst of catch-up steps.
+        static constexpr int MAX_CATCH_UP = 5;
+
+        struct Slot {
+            State state;
+            Clock::time_point time;     // scheduled time of the step that produced it
+            uint64_t step = 0;
+        };
+
+        static Clock::duration duration(double secondsValue) {
+            return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(secondsValue));
+        }
+
+        static double seconds(Clock::duration value) {
+            return std::chrono::duration<double>(value).count();
+        }
+
+        // Produces one state from lastPublished_ into back_ and publishes it.
+        void stepOnce() {
+            const Slot& input = slots_[lastPublished_];
+            Slot& output = slots_[back_];
+            step_(input.state, output.state, stepSeconds_);
+            edits_.drain([&](EditFunction& edit) {
+                EditFunction apply = std::move(edit);
+                apply(output.state);
+            });
+            output.time = nextStep_;
+            output.step = input.step + 1;
+
+            uint32_t freed = ready_.exchange(back_ | NEW_STATE, std::memory_order_acq_rel);
+            lastPublished_ = back_;
+            back_ = freed & SLOT_MASK;
+        }
+
+        void runDueSteps() {
+            if (paused_.load()) {
+                nextStep_ = Clock::now() + duration(stepSeconds_);
+                return;
+            }
+            Clock::time_point now = Clock::now();
+            for (int i = 0; i < MAX_CATCH_UP && nextStep_ <= now; ++i) {
+                stepOnce();
+                nextStep_ += duration(stepSeconds_);
+            }
+            if (nextStep_ <= now) {
+                nextStep_ = now + duration(stepSeconds_);
+            }
+        }
+
+#if FERN_THREADS
+        void run() {
+            while (running_.load()) {
+                runDueSteps();
+                std::this_thread::sleep_until(std::min(nextStep_, Clock::now() + duration(stepSeconds_)));
+            }
+        }
+#endif
+
+        StepFunction step_;
+        double stepSeconds_;
+
+        // Four buffers: the render side holds previous_ and current_, the
+        // simulation holds back_, and ready_ holds the hand-off slot. The
+        // simulation also reads lastPublished_, which the render side may be
+        // reading too; it only ever writes back_, which nobody else holds.
+        Slot slots_[4];
+        std::atomic<uint32_t> ready_{2};
+        uint32_t previous_ = 0;
+        uint32_t current_ = 1;
+        uint32_t back_ = 3;
+        uint32_t lastPublished_ = 1;
+
+        Clock::time_point nextStep_;
+        std::atomic<bool> running_{false};
+        std::atomic<bool> paused_{false};
+        SpscQueue<EditFunction, 64> edits_;
+#if FERN_THREADS
+        std::thread thread_;
+#endif
+    };
+}
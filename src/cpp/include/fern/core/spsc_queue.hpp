@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace Fern {
+    // Bounded lock-free single-producer / single-consumer ring buffer.
+    // One thread may push while another pops; neither ever blocks. When the
+    // ring is full push() fails and the caller decides what to drop.
+    template <typename T, size_t Capacity>
+    class SpscQueue {
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0,
+                      "SpscQueue capacity must be a power of two");
+    public:
+        // A value that does not fit is left untouched, moved-from or not.
+        bool push(const T& value) { return pushItem(value); }
+        bool push(T&& value) { return pushItem(std::move(value)); }
+
+        bool pop(T& value) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            value = items_[head & (Capacity - 1)];
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Pops everything that was visible when the call started and hands it
+        // to fn in order. Publishes the new head once, so a whole batch costs
+        // two atomic operations. Returns the number of items drained.
+        template <typename Fn>
+        size_t drain(Fn&& fn) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            size_t tail = tail_.load(std::memory_order_acquire);
+            for (size_t i = head; i != tail; ++i) {
+                fn(items_[i & (Capacity - 1)]);
+            }
+            head_.store(tail, std::memory_order_release);
+            return tail - head;
+        }
+
+        bool empty() const {
+            return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+        }
+
+    private:
+        template <typename U>
+        bool pushItem(U&& value) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+                return false;
+            }
+            items_[tail & (Capacity - 1)] = std::forward<U>(value);
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Producer and consumer indices live on separate cache lines.
+        alignas(64) std::atomic<size_t> head_{0};
+        alignas(64) std::atomic<size_t> tail_{0};
+        alignas(64) T items_[Capacity];
+    };
+}
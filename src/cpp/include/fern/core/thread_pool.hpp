@@ -0,0 +1,121 @@
+#pragma once
+
+#include "types.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <utility>
+
+// Browser builds only get threads when compiled with -pthread; without it every
+// parallel helper below runs inline on the calling thread. Defining
+// FERN_THREADS to 0 forces the same on other platforms.
+#ifndef FERN_THREADS
+#if defined(__EMSCRIPTEN__) && !defined(__EMSCRIPTEN_PTHREADS__)
+#define FERN_THREADS 0
+#else
+#define FERN_THREADS 1
+#endif
+#endif
+
+namespace Fern {
+    class ThreadPool;
+
+    // Set of tasks that can be waited on together. wait() runs queued tasks
+    // while it waits, so groups may be nested without starving the pool.
+    class TaskGroup {
+    public:
+        TaskGroup() = default;
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+        ~TaskGroup() { wait(); }
+
+        void run(std::function<void()> task);
+        void wait();
+
+    private:
+        friend class ThreadPool;
+        std::atomic<int> pending_{0};
+    };
+
+    // Work-stealing pool. Each worker owns a deque: it pushes and pops its own
+    // work at the back and steals from the front of the others' when idle.
+    // Tasks submitted from outside the pool are spread across the workers.
+    class ThreadPool {
+    public:
+        static ThreadPool& getInstance();
+
+        // Worker threads, not counting the thread that waits on a group.
+        int getWorkerCount() const;
+
+        // Calls fn(context, chunk) for every chunk in [0, chunkCount), spread
+        // over the workers and the calling thread, and returns when all are
+        // done. Chunks are claimed dynamically, so uneven chunks balance out.
+        using ChunkFunction = void (*)(void* context, int chunk);
+        void forEachChunk(int chunkCount, ChunkFunction fn, void* context);
+
+    private:
+        friend class TaskGroup;
+        struct Impl;
+
+        ThreadPool();
+        ~ThreadPool() = delete;     // workers run until the process exits
+
+        void submit(TaskGroup& group, std::function<void()> task);
+        bool runPendingTask();
+
+        Impl* impl_;
+    };
+
+    // Calls fn(chunkBegin, chunkEnd) over [begin, end) in chunks of at least
+    // grain elements, in parallel.
+    template <typename Fn>
+    void parallelFor(int begin, int end, int grain, Fn&& fn) {
+        if (end <= begin) return;
+        grain = std::max(grain, 1);
+        int chunks = (end - begin + grain - 1) / grain;
+        if (chunks == 1) {
+            fn(begin, end);
+            return;
+        }
+
+        struct Context {
+            int begin;
+            int end;
+            int grain;
+            Fn* fn;
+        } context = {begin, end, grain, &fn};
+
+        ThreadPool::getInstance().forEachChunk(chunks, [](void* data, int chunk) {
+            Context& ctx = *static_cast<Context*>(data);
+            int chunkBegin = ctx.begin + chunk * ctx.grain;
+            (*ctx.fn)(chunkBegin, std::min(chunkBegin + ctx.grain, ctx.end));
+        }, &context);
+    }
+
+    // Row bands of a canvas or image: fn(yBegin, yEnd) per band.
+    template <typename Fn>
+    void parallelForRows(int yBegin, int yEnd, int bandHeight, Fn&& fn) {
+        parallelFor(yBegin, yEnd, bandHeight, std::forward<Fn>(fn));
+    }
+
+    // 2D tiles covering area, visited in row-major order: fn(const Rect& tile).
+    // Edge tiles are clipped to the area.
+    template <typename Fn>
+    void parallelForTiles(const Rect& area, int tileWidth, int tileHeight, Fn&& fn) {
+        if (area.width <= 0 || area.height <= 0) return;
+        tileWidth = std::max(tileWidth, 1);
+        tileHeight = std::max(tileHeight, 1);
+        int columns = (area.width + tileWidth - 1) / tileWidth;
+        int rows = (area.height + tileHeight - 1) / tileHeight;
+
+        parallelFor(0, columns * rows, 1, [&](int first, int last) {
+            for (int i = first; i < last; ++i) {
+                int x = area.x + (i % columns) * tileWidth;
+                int y = area.y + (i / columns) * tileHeight;
+                fn(Rect(x, y,
+                        std::min(tileWidth, area.x + area.width - x),
+                        std::min(tileHeight, area.y + area.height - y)));
+            }
+        });
+    }
+}
@@ -12,10 +12,38 @@ namespace Fern {
         Point(int x, int y) : x(x), y(y) {}
     };
     
+    struct Rect {
+        int x = 0;
+        int y = 0;
+        int width = 0;
+        int height = 0;
+        
+        Rect() = default;
+        Rect(int x, int y, int width, int height) : x(x), y(y), width(width), height(height) {}
+        
+        bool contains(int px, int py) const {
+            return px >= x && px < x + width && py >= y && py < y + height;
+        }
+    };
+    
     struct InputState {
         int mouseX = 0;
         int mouseY = 0;
         bool mouseDown = false;
         bool mouseClicked = false;
     };
+    
+    enum class InputEventType {
+        Move,       // pointer position changed
+        Down,       // button pressed
+        Up,         // button released
+        Click       // sent with Down, mirrors InputState::mouseClicked
+    };
+    
+    struct InputEvent {
+        InputEventType type = InputEventType::Move;
+        int x = 0;
+        int y = 0;
+        double timestamp = 0.0;     // milliseconds on a monotonic clock
+    };
 }
\ No newline at end of file
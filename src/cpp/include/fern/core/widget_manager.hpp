@@ -1,12 +1,27 @@
 #pragma once
 #include "../ui/widget.hpp"
 #include "../core/input.hpp"
+#include <cstdint>
 #include <vector>
 #include <memory>
+#include <unordered_map>
 #include <algorithm>
 
 namespace Fern
 {
+    // Stable reference to a registered widget. The generation makes handles
+    // to removed widgets stale instead of aliasing a widget that reuses the slot.
+    struct WidgetHandle {
+        uint32_t index = UINT32_MAX;
+        uint32_t generation = 0;
+
+        bool isValid() const { return index != UINT32_MAX; }
+        bool operator==(const WidgetHandle& other) const {
+            return index == other.index && generation == other.generation;
+        }
+        bool operator!=(const WidgetHandle& other) const { return !(*this == other); }
+    };
+
     class WidgetManager {
     public: 
         static WidgetManager& getInstance(){
@@ -14,44 +29,102 @@ namespace Fern
             return instance;
         }
 
-        void addWidget(std::shared_ptr<Widget> widget){
-             widgets_.push_back(widget);
-        }
+        WidgetHandle addWidget(std::shared_ptr<Widget> widget);
+        void removeWidget(WidgetHandle handle);
+        void removeWidget(std::shared_ptr<Widget> widget);
 
-        void removeWidget(std::shared_ptr<Widget> widget) {
-            widgets_.erase(
-                std::remove_if(widgets_.begin(), widgets_.end(),
-                    [&widget](const auto& w) { return w == widget; }),
-                widgets_.end()
-            );
-        }
+        // Returns nullptr once the widget has been removed.
+        Widget* getWidget(WidgetHandle handle) const;
+        WidgetHandle findHandle(const Widget* widget) const;
 
-        // for proper Z handling, the update has been reversed
-        void updateAll(const InputState& input) {
-            bool inputHandled = false;
-            for (auto it = widgets_.rbegin(); it != widgets_.rend(); ++it) {
-                if (!inputHandled) {
-                    inputHandled = (*it)->handleInput(input);
-                }
-            }
-        }
+        // Widgets publish their bounds once, when the index is rebuilt.
+        // Call this after moving or resizing a registered widget.
+        void invalidateBounds() { indexDirty_ = true; }
 
-         void renderAll() {
-            for (auto& widget : widgets_) {
-                widget->render();
-            }
-        }
+        // Widgets that animate or poll can ask to receive handleInput()
+        // every frame, even when the input has not changed.
+        void setTicking(WidgetHandle handle, bool ticking);
+
+        // Per-frame entry point used by the render loop: dispatches the
+        // current input only if Input recorded events this frame or the widget
+        // set changed, and otherwise just ticks the widgets that asked for it.
+        void processInput();
+
+        // for proper Z handling, the update has been reversed
+        void updateAll(const InputState& input);
+        void renderAll();
 
     private:
+        // Built-in widget types are dispatched with direct, non-virtual calls.
+        // Subclasses of them are registered as Custom and go through the vtable.
+        enum class WidgetKind : uint8_t { Custom, Button, Container };
+
+        // One per registered widget, kept in z-order. Removed widgets leave a
+        // null entry behind that is compacted when the index is rebuilt.
+        struct Entry {
+            Widget* widget = nullptr;
+            uint32_t slot = 0;
+            WidgetKind kind = WidgetKind::Custom;
+            bool bounded = false;
+            bool hot = false;       // contained the pointer at the last update
+            bool ticking = false;
+            Rect bounds;
+        };
+
+        struct Slot {
+            std::shared_ptr<Widget> owner;
+            uint32_t generation = 0;
+            uint32_t entry = 0;     // position in entries_
+        };
+
+        // Uniform grid over the union of all published bounds, clipped to the
+        // canvas. Each cell lists the z-indices of the widgets overlapping it.
+        // Past MAX_GRID_CELLS (8K screens fit) bounded widgets are dispatched
+        // like unbounded ones instead of indexed.
+        static constexpr int CELL_SIZE = 64;
+        static constexpr int64_t MAX_GRID_CELLS = 1 << 14;
+
         WidgetManager() = default;
-        std::vector<std::shared_ptr<Widget>> widgets_;    
+        static WidgetKind classify(const Widget& widget);
+        static bool boundsOf(const Entry& entry, Rect& bounds);
+        void rebuildIndex();
+        void collectCandidates(const InputState& input);
+        void updateHot(const InputState& input, size_t visited);
+        size_t dispatch(const std::vector<uint32_t>& targets, const InputState& input);
+
+        std::vector<Entry> entries_;
+        std::vector<Slot> slots_;
+        std::vector<uint32_t> freeSlots_;
+        std::unordered_map<const Widget*, uint32_t> slotOf_;
+        // Widgets removed since the last rebuild; kept alive so removal from
+        // inside a signal handler never frees the widget that is dispatching.
+        std::vector<std::shared_ptr<Widget>> removed_;
+        
+        bool indexDirty_ = false;
+        int gridX_ = 0;
+        int gridY_ = 0;
+        int gridCols_ = 0;
+        int gridRows_ = 0;
+        std::vector<std::vector<uint32_t>> cells_;
+        std::vector<uint32_t> unbounded_;
+        std::vector<uint32_t> hot_;
+        std::vector<uint32_t> pointed_;     // under the pointer this update
+        // A widget the pointer left was skipped because one above it handled
+        // the input; the next frame updates again even without events.
+        bool hoverPending_ = false;
+        std::vector<uint32_t> ticking_;     // z-indices, topmost first
+        std::vector<uint32_t> candidates_;
     };
 
-    inline void addWidget(std::shared_ptr<Widget> widget) {
-        WidgetManager::getInstance().addWidget(widget);
+    inline WidgetHandle addWidget(std::shared_ptr<Widget> widget) {
+        return WidgetManager::getInstance().addWidget(widget);
     }
     
     inline void removeWidget(std::shared_ptr<Widget> widget) {
         WidgetManager::getInstance().removeWidget(widget);
     }
+
+    inline void removeWidget(WidgetHandle handle) {
+        WidgetManager::getInstance().removeWidget(handle);
+    }
 } // namespace Fern
@@ -3,7 +3,12 @@
 // Include all component headers
 #include "core/canvas.hpp"
 #include "core/input.hpp"
+#include "core/dynamic_resolution.hpp"
 #include "graphics/primitives.hpp"
+#include "graphics/shader.hpp"
+#include "graphics/progressive.hpp"
+#include "graphics/layers.hpp"
+#include "graphics/path.hpp"
 #include "graphics/colors.hpp"
 #include "text/font.hpp"
 #include "ui/widgets.hpp"
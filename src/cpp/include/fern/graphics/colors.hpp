@@ -70,6 +70,17 @@ namespace Fern {
         
         // Color blending function
         uint32_t blendColors(uint32_t color1, uint32_t color2, float t);
+        
+        // Blend src over dst with an 8-bit alpha (0 = dst, 255 = src).
+        // Works on two channels at a time, so it is cheap enough for per-pixel use.
+        inline uint32_t blendAlpha(uint32_t dst, uint32_t src, uint32_t alpha) {
+            uint32_t inv = 255 - alpha;
+            uint32_t rb = (src & 0x00FF00FF) * alpha + (dst & 0x00FF00FF) * inv + 0x00800080;
+            uint32_t ag = ((src >> 8) & 0x00FF00FF) * alpha + ((dst >> 8) & 0x00FF00FF) * inv + 0x00800080;
+            rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+            ag = (ag + ((ag >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+            return rb | ag;
+        }
     }
     
     // Rest of your gradient code remains the same
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "../core/canvas.hpp"
+#include "../core/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Fern {
+    class Compositor;
+    class Layer;
+
+    // Saved contents of a layer. Tiles that did not change between two
+    // snapshots are shared, so keeping many of them costs memory in
+    // proportion to what was painted in between. Cheap to copy.
+    class LayerSnapshot {
+    public:
+        bool isValid() const { return layer_ != nullptr; }
+
+    private:
+        friend class Layer;
+        using Tile = std::shared_ptr<const std::vector<uint32_t>>;
+
+        const Layer* layer_ = nullptr;
+        std::vector<Tile> tiles_;
+    };
+
+    // Offscreen ARGB image that keeps its contents between frames. Pixels
+    // with alpha 0 are transparent; layers start out fully transparent.
+    class Layer {
+    public:
+        const std::string& getName() const { return name_; }
+        Canvas& getCanvas() { return canvas_; }
+
+        void setOpacity(float opacity);
+        float getOpacity() const { return opacity_; }
+        void setVisible(bool visible);
+        bool isVisible() const { return visible_; }
+
+        void clear(uint32_t color = 0);
+
+        // Call after changing pixels directly through getCanvas().
+        void markDirty(const Rect& area);
+
+        // Copies only the tiles marked dirty since the previous snapshot;
+        // the rest are shared with it.
+        LayerSnapshot snapshot();
+        // Puts back the contents of a snapshot taken from this layer,
+        // rewriting only the tiles that differ from it.
+        void restore(const LayerSnapshot& snapshot);
+
+    private:
+        friend class Compositor;
+        Layer(Compositor& owner, const std::string& name, int width, int height);
+
+        void markTiles(const Rect& area);
+        void resetTiles(uint32_t color);
+
+        Compositor& owner_;
+        std::string name_;
+        std::vector<uint32_t> pixels_;
+        Canvas canvas_;
+        float opacity_ = 1.0f;
+        bool visible_ = true;
+
+        // Contents as of the last snapshot, tile by tile, plus the tiles
+        // written since then.
+        int columns_;
+        int rows_;
+        std::vector<LayerSnapshot::Tile> saved_;
+        std::vector<uint8_t> changed_;
+        std::vector<int> changedList_;
+    };
+
+    // Linear undo/redo over snapshots of one layer. Call commit() after each
+    // finished edit, e.g. when a stroke ends.
+    //
+    // The history refers to its layer and must not outlive it: destroy it
+    // before removing the layer or destroying the compositor.
+    class LayerHistory {
+    public:
+        // Keeps at most depth undo steps; the initial state counts as the
+        // first entry.
+        explicit LayerHistory(Layer& layer, size_t depth = 64);
+
+        void commit();
+        bool undo();
+        bool redo();
+        bool canUndo() const { return position_ > 0; }
+        bool canRedo() const { return position_ + 1 < states_.size(); }
+
+    private:
+        Layer& layer_;
+        size_t depth_;
+        std::deque<LayerSnapshot> states_;
+        size_t position_ = 0;
+    };
+
+    // Stack of named layers blended into the canvas, bottom to top, over a
+    // solid background.
+    //
+    // The blended result is kept between frames and only the tiles that
+    // changed since the last composite() are blended again, so a frame costs
+    // the ink painted since the last one plus one copy to the canvas, not a
+    // redraw of everything painted so far.
+    class Compositor {
+    public:
+        static constexpr int TILE_SIZE = 64;
+
+        Compositor(int width, int height, uint32_t background = 0xFF000000);
+        // Layers refer back to their compositor, so it stays where it was
+        // constructed. Deleting the copy operations removes the moves too.
+        Compositor(const Compositor&) = delete;
+        Compositor& operator=(const Compositor&) = delete;
+
+        // New layers go on top. Names are unique; adding an existing name
+        // returns that layer.
+        Layer& addLayer(const std::string& name);
+        Layer* getLayer(const std::string& name);
+        // Destroys the layer; references to it, and any LayerHistory over
+        // it, must not be used afterwards.
+        void removeLayer(const std::string& name);
+        // 0 is the bottom of the stack.
+        void moveLayer(const std::string& name, int index);
+
+        void setBackground(uint32_t color);
+
+        // Runs fn with Draw:: calls redirected to the layer and marks bounds
+        // as changed. bounds must cover everything fn draws.
+        template <typename Fn>
+        void paint(const std::string& name, const Rect& bounds, Fn&& fn) {
+            Layer* layer = getLayer(name);
+            if (!layer) return;
+            Canvas* previous = globalCanvas;
+            globalCanvas = &layer->canvas_;
+            fn();
+            globalCanvas = previous;
+            layer->markDirty(bounds);
+        }
+
+        void invalidate(const Rect& area);
+        void invalidateAll();
+
+        // Re-blends the changed tiles and copies the result to globalCanvas.
+        void composite();
+
+        int getWidth() const { return width_; }
+        int getHeight() const { return height_; }
+
+    private:
+        void blendTile(int tile);
+
+        int width_;
+        int height_;
+        uint32_t background_;
+        std::vector<std::unique_ptr<Layer>> layers_;    // bottom first
+        std::vector<uint32_t> result_;
+        int columns_;
+        int rows_;
+        std::vector<uint8_t> dirty_;
+        std::vector<int> dirtyList_;
+    };
+}
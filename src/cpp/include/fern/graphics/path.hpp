@@ -0,0 +1,64 @@
+#pragma once
+
+#include "primitives.hpp"
+#include <cstdint>
+#include <vector>
+
+namespace Fern {
+    // Vector outline made of lines, Bézier curves and arcs, drawn filled or
+    // stroked. Coordinates may be fractional; (x, y) is the center of pixel
+    // (x, y), as for the Draw functions.
+    //
+    // Curves are split into as few line segments as keep them within the
+    // tolerance (a quarter pixel by default) when the path is drawn.
+    class Path {
+    public:
+        // Starts a new subpath.
+        Path& moveTo(float x, float y);
+        Path& lineTo(float x, float y);
+        Path& quadTo(float cx, float cy, float x, float y);
+        Path& cubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y);
+        // Rounds the corner at (x1, y1) between the current point and
+        // (x2, y2) with a circular arc of the given radius, joined to the
+        // current point by a straight line.
+        Path& arcTo(float x1, float y1, float x2, float y2, float radius);
+        // Joins the subpath back to its first point.
+        Path& close();
+
+        void clear();
+        bool isEmpty() const { return verbs_.empty(); }
+
+        void setTolerance(float pixels);
+        float getTolerance() const { return tolerance_; }
+
+        // Open subpaths are filled as if closed.
+        void fill(uint32_t color, FillRule rule = FillRule::NonZero) const;
+        void stroke(float width, uint32_t color, LineJoin join = LineJoin::Miter,
+                    LineCap cap = LineCap::Butt) const;
+
+    private:
+        enum class Verb : uint8_t {
+            Move,       // x, y
+            Line,       // x, y
+            Quad,       // cx, cy, x, y
+            Cubic,      // c1x, c1y, c2x, c2y, x, y
+            Arc,        // center x, center y, radius, start angle, sweep
+            Close
+        };
+
+        struct Contour {
+            std::vector<float> points;      // x, y pairs
+            bool closed;
+        };
+
+        void beginSubpath(float x, float y);
+        void flatten(std::vector<Contour>& contours) const;
+
+        std::vector<Verb> verbs_;
+        std::vector<float> coords_;
+        float tolerance_ = 0.25f;
+        float startX_ = 0.0f, startY_ = 0.0f;
+        float currentX_ = 0.0f, currentY_ = 0.0f;
+        bool open_ = false;     // a subpath has a current point
+    };
+}
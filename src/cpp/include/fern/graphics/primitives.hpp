@@ -1,13 +1,78 @@
 #pragma once
 
 #include "../core/canvas.hpp"
+#include "../core/types.hpp"
 #include <cstdint>
+#include <vector>
 
 namespace Fern {
+    enum class LineJoin {
+        Miter,      // sharp corner; beveled when longer than 4x the width
+        Round,
+        Bevel
+    };
+    
+    enum class LineCap {
+        Butt,       // ends flush with the end points
+        Round,
+        Square      // extends half the width past the end points
+    };
+    
+    enum class FillRule {
+        NonZero,    // inside where the outline winds around the point
+        EvenOdd     // inside where a ray crosses the outline an odd number of times
+    };
+    
+    enum class Shading {
+        Flat,       // whole triangle in the color of its first vertex
+        Gouraud     // vertex colors blended across the triangle
+    };
+    
+    // Threading: Draw functions draw into globalCanvas and may run on
+    // several threads at once, e.g. from parallelFor bands or Compositor
+    // tiles, as long as the calls write disjoint pixels. The shared stamp
+    // cache behind circle(), stamp() and line() is locked. globalCanvas
+    // itself must not be swapped (Compositor::paint does) while another
+    // thread is drawing.
     namespace Draw {
         void fill(uint32_t color);
         void rect(int x, int y, int width, int height, uint32_t color);
+        // Corners are quarter circles of radius, which is capped at half
+        // the shorter side.
+        void roundedRect(int x, int y, int width, int height, int radius, uint32_t color);
         void circle(int cx, int cy, int radius, uint32_t color);
+        void ellipse(int cx, int cy, int rx, int ry, uint32_t color);
+        
+        // Round brush dab, hard or with antialiased edges. Brush shapes are
+        // rasterized once per radius and kept in a bounded cache, so
+        // repeated stamps (and circle(), line()) only write pixels.
+        void stamp(int cx, int cy, int radius, uint32_t color, bool antialiased = true);
         void line(int x1, int y1, int x2, int y2, int thickness, uint32_t color);
+        
+        // Connected path stroked thickness pixels wide. The whole outline,
+        // joins and caps included, is filled as one region row by row, so
+        // every pixel is written once however the segments overlap.
+        void polyline(const std::vector<Point>& points, int thickness, LineJoin join, LineCap cap,
+                      uint32_t color);
+        
+        // Filled polygon, closed from the last point back to the first. Any
+        // shape works, concave and self-intersecting included; rule decides
+        // which overlapping regions count as inside.
+        void polygon(const std::vector<Point>& points, uint32_t color,
+                     FillRule rule = FillRule::NonZero);
+        
+        // Batches: one call for many shapes, drawn in order as if by repeated
+        // circle() / rect() calls. radii and colors hold one value per shape,
+        // or a single value shared by all. Shapes are binned into row bands
+        // that are drawn in parallel.
+        void circles(const std::vector<Point>& centers, const std::vector<int>& radii,
+                     const std::vector<uint32_t>& colors);
+        void rects(const std::vector<Rect>& rects, const std::vector<uint32_t>& colors);
+        
+        // Indexed triangle list: every three indices name one triangle's
+        // vertices. colors holds one color per vertex, or a single color.
+        // Triangles sharing an edge never both draw its pixels.
+        void triangles(const std::vector<Point>& vertices, const std::vector<int>& indices,
+                       const std::vector<uint32_t>& colors, Shading shading = Shading::Gouraud);
     }
 }
\ No newline at end of file
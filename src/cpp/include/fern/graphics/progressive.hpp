@@ -0,0 +1,113 @@
+#pragma once
+
+#include "../core/canvas.hpp"
+#include "../core/thread_pool.hpp"
+#include "../core/types.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace Fern {
+    // Coarse-to-fine renderer for content that is too slow to evaluate in one
+    // frame, such as fractals or heatmaps.
+    //
+    // - The first pass evaluates one sample per coarse block and fills the
+    //   whole block with it. Each later pass halves the block size and only
+    //   evaluates the samples earlier passes did not cover, until every pixel
+    //   has its own value.
+    // - render() stops once the frame's time budget is spent and continues
+    //   where it left off on the next call, so a frame costs at most the
+    //   budget plus one band of rows however expensive the content is.
+    // - invalidate() aborts the current run when the inputs change; the next
+    //   render() starts over from the coarse pass. The previous image stays
+    //   visible wherever the new run has not reached yet.
+    // - Results live in the renderer's own image, which is copied to the
+    //   canvas on every call, so the canvas may be cleared between frames.
+    class ProgressiveRenderer {
+    public:
+        // coarseBlockSize is rounded up to a power of two.
+        explicit ProgressiveRenderer(int coarseBlockSize = 8, double budgetMs = 8.0);
+
+        void setBudget(double milliseconds) { budgetMs_ = milliseconds; }
+        double getBudget() const { return budgetMs_; }
+
+        void invalidate();
+        bool isComplete() const { return blockSize_ == 0; }
+        // Block size of the pass in progress, 0 once every pixel is final.
+        int getBlockSize() const { return blockSize_; }
+
+        // Advances the run for area and draws the current image. fn(x, y)
+        // returns the color of canvas pixel (x, y) and is called from several
+        // threads at once. Changing the area restarts the run. Returns true
+        // when the image is complete.
+        template <typename Fn>
+        bool render(const Rect& area, Fn&& fn);
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        // Rows advanced between two checks of the clock, at full resolution.
+        static constexpr int BAND_HEIGHT = 32;
+
+        bool begin(const Rect& area);
+        void advance(int bandHeight);
+        void present() const;
+
+        template <typename Fn>
+        void renderBlockRow(int y, Fn& fn);
+
+        int coarseBlockSize_;
+        double budgetMs_;
+        Rect area_;
+        std::vector<uint32_t> image_;
+        int blockSize_ = 0;
+        int nextRow_ = 0;
+    };
+
+    template <typename Fn>
+    void ProgressiveRenderer::renderBlockRow(int y, Fn& fn) {
+        int block = blockSize_;
+        int width = area_.width;
+        int rowEnd = std::min(y + block, area_.height);
+
+        // Samples on even rows and even columns of this pass were already
+        // taken by the previous, coarser one.
+        bool coarseRow = block < coarseBlockSize_ && y % (2 * block) == 0;
+        int first = coarseRow ? block : 0;
+        int step = coarseRow ? 2 * block : block;
+
+        for (int x = first; x < width; x += step) {
+            uint32_t color = fn(area_.x + x, area_.y + y);
+            int count = std::min(block, width - x);
+            for (int row = y; row < rowEnd; ++row) {
+                std::fill_n(image_.data() + (size_t)row * width + x, count, color);
+            }
+        }
+    }
+
+    template <typename Fn>
+    bool ProgressiveRenderer::render(const Rect& area, Fn&& fn) {
+        if (!begin(area)) return isComplete();
+
+        Clock::time_point start = Clock::now();
+        while (!isComplete()) {
+            int block = blockSize_;
+            int bandHeight = std::max(BAND_HEIGHT, block);
+            int bandEnd = std::min(nextRow_ + bandHeight, area_.height);
+
+            parallelForRows(nextRow_, bandEnd, block, [&](int y0, int y1) {
+                for (int y = y0; y < y1; y += block) {
+                    renderBlockRow(y, fn);
+                }
+            });
+            advance(bandHeight);
+
+            std::chrono::duration<double, std::milli> elapsed = Clock::now() - start;
+            if (elapsed.count() >= budgetMs_) break;
+        }
+
+        present();
+        return isComplete();
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../core/canvas.hpp"
+#include "../core/thread_pool.hpp"
+#include "../core/types.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace Fern {
+    namespace Draw {
+        // Tile size used by the shading helpers: 128 pixels (512 bytes) wide
+        // so each tile row stays within a few cache lines.
+        constexpr int SHADE_TILE_WIDTH = 128;
+        constexpr int SHADE_TILE_HEIGHT = 32;
+
+        // Lane variant for vectorized shaders: fn(x, y, out) writes Lanes
+        // consecutive pixels (x .. x + Lanes - 1 on row y) to out. fn always
+        // sees a full group; at the right edge of a tile it writes into a
+        // scratch buffer and only the visible pixels are copied out.
+        template <int Lanes, typename Fn>
+        void shadeLanes(const Rect& area, Fn&& fn) {
+            static_assert(Lanes > 0, "shadeLanes needs at least one lane");
+            if (!globalCanvas) return;
+            int stride = globalCanvas->getWidth();
+            int x0 = std::max(area.x, 0);
+            int y0 = std::max(area.y, 0);
+            int x1 = std::min(area.x + area.width, stride);
+            int y1 = std::min(area.y + area.height, globalCanvas->getHeight());
+            Rect clipped(x0, y0, std::max(x1 - x0, 0), std::max(y1 - y0, 0));
+            uint32_t* buffer = globalCanvas->getBuffer();
+
+            parallelForTiles(clipped, SHADE_TILE_WIDTH, SHADE_TILE_HEIGHT, [&](const Rect& tile) {
+                int end = tile.x + tile.width;
+                for (int y = tile.y; y < tile.y + tile.height; ++y) {
+                    uint32_t* row = buffer + (size_t)y * stride;
+                    int x = tile.x;
+                    for (; x + Lanes <= end; x += Lanes) {
+                        fn(x, y, row + x);
+                    }
+                    if (x < end) {
+                        uint32_t tail[Lanes];
+                        fn(x, y, tail);
+                        std::copy(tail, tail + (end - x), row + x);
+                    }
+                }
+            });
+        }
+
+        // Procedural fill: every pixel of area gets fn(x, y), a uint32_t color.
+        // fn is inlined into the loop (no std::function, no per-pixel
+        // indirection) and tiles are shaded in parallel, so fn must be safe to
+        // call from several threads at once.
+        // A single lane never takes the scratch path, so this is the plain
+        // per-pixel loop.
+        template <typename Fn>
+        void shade(const Rect& area, Fn&& fn) {
+            shadeLanes<1>(area, [&](int x, int y, uint32_t* out) {
+                *out = fn(x, y);
+            });
+        }
+    }
+}
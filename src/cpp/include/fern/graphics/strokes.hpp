@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../core/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Fern {
+    // Records freehand strokes as simplified polylines.
+    //
+    // Points are simplified while the stroke is drawn (Douglas-Peucker over
+    // short windows of input) and stored as variable-length deltas, usually
+    // two bytes per kept point. Every stroke keeps its bounding box so
+    // drawing and hit testing skip strokes outside the area of interest.
+    class StrokeRecorder {
+    public:
+        // tolerance: how far, in pixels, the kept polyline may stray from
+        // the input points.
+        explicit StrokeRecorder(float tolerance = 1.0f);
+
+        // size is the brush radius, as for Draw::line.
+        void begin(int x, int y, int size, uint32_t color);
+        void addPoint(int x, int y);
+        void end();
+        bool isRecording() const { return recording_; }
+
+        size_t size() const { return strokes_.size(); }
+        void removeLast();
+        void clear();
+
+        // Covers every pixel the stroke draws.
+        Rect getBounds(size_t stroke) const { return strokes_[stroke].bounds; }
+        int getBrushSize(size_t stroke) const { return strokes_[stroke].size; }
+        uint32_t getColor(size_t stroke) const { return strokes_[stroke].color; }
+        // Replaces out with the stroke's kept points.
+        void getPoints(size_t stroke, std::vector<Point>& out) const;
+
+        // Draws the strokes that overlap area (all strokes on the canvas
+        // by default), oldest first.
+        void draw() const;
+        void draw(const Rect& area) const;
+
+        // Topmost stroke passing within its brush radius plus slop of
+        // (x, y), or -1.
+        int hitTest(int x, int y, int slop = 0) const;
+
+        // Memory held for the recorded points and stroke records.
+        size_t bytes() const;
+
+    private:
+        static const size_t WINDOW = 64;
+
+        struct Stroke {
+            Rect bounds;
+            uint32_t color;
+            int size;
+            Point first;
+            uint32_t offset;        // into data_
+            uint32_t pointCount;
+        };
+
+        void flush();
+        void emit(const Point& point);
+        void updateBounds(const Point& point);
+
+        float tolerance_;
+        std::vector<Stroke> strokes_;
+        std::vector<uint8_t> data_;
+
+        // Stroke being recorded: input points not yet simplified, starting
+        // with the last point emitted.
+        bool recording_ = false;
+        std::vector<Point> pending_;
+        Point last_;
+        int minX_, minY_, maxX_, maxY_;
+        mutable std::vector<Point> scratch_;
+    };
+}
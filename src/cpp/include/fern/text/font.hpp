@@ -6,5 +6,12 @@ namespace Fern {
     namespace Text {
         void drawChar(char c, int x, int y, int scale, uint32_t color);
         void drawText(const char* text, int x, int y, int scale, uint32_t color);
+        
+        // Smooth text: glyphs drawn with scale > 1 are upscaled with an
+        // anti-aliasing filter instead of nearest-neighbor. Each (glyph, scale)
+        // mask is built once and kept in a bounded cache (1 MB, least recently
+        // used dropped first), so drawing stays a single blit per glyph.
+        void setSmoothing(bool enabled);
+        bool isSmoothing();
     }
-}
\ No newline at end of file
+}
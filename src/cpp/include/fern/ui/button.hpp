@@ -19,6 +19,7 @@ namespace Fern {
         int textScale;
         uint32_t textColor;
         std::function<void()> onClick; // deprecated
+        int cornerRadius = 0;          // 0 keeps square corners
     };
     
     class Button : public Widget {
@@ -27,6 +28,7 @@ namespace Fern {
         
         void render() override;
         bool handleInput(const InputState& input) override;
+        bool getBounds(Rect& bounds) const override;
 
         Signal<> onClick;       
         Signal<bool> onHover;   
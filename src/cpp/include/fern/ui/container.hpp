@@ -2,6 +2,7 @@
 
 #include "widget.hpp"
 #include "../graphics/colors.hpp"
+#include <memory>
 
 namespace Fern {
     class Container : public Widget {
@@ -10,6 +11,7 @@ namespace Fern {
         
         void render() override;
         bool handleInput(const InputState&) override { return false; }
+        bool getBounds(Rect& bounds) const override;
         
     private:
         int x_;
@@ -20,6 +22,9 @@ namespace Fern {
     };
     
     // Factory functions
+    // Registers a container with the WidgetManager. Containers made here
+    // are allocated from a shared pool, like ButtonWidget's buttons.
+    std::shared_ptr<Container> ContainerWidget(int x, int y, int width, int height, uint32_t color);
     void BasicContainer(uint32_t color, int x, int y, int width, int height);
     void CenteredContainer(int width, int height, uint32_t color);
     void LinearGradientContainer(int x, int y, int width, int height, const LinearGradient& gradient);
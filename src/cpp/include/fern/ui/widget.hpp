@@ -9,5 +9,11 @@ namespace Fern {
         virtual ~Widget() = default;
         virtual void render() = 0;
         virtual bool handleInput(const InputState& input) = 0;
+        
+        // Screen-space area that reacts to the pointer. Widgets that publish
+        // bounds are indexed by the WidgetManager and only receive input when
+        // the pointer is inside them (or has just left). Widgets returning
+        // false receive input every update.
+        virtual bool getBounds(Rect& bounds) const { (void)bounds; return false; }
     };
 }
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "../../include/fern/core/canvas.hpp"
+#include "../../include/fern/core/thread_pool.hpp"
+#include <algorithm>
 #include <cstring>
 
 namespace Fern {
@@ -8,9 +10,12 @@ namespace Fern {
         : buffer_(buffer), width_(width), height_(height) {}
     
     void Canvas::clear(uint32_t color) {
-        for (int i = 0; i < width_ * height_; ++i) {
-            buffer_[i] = color;
-        }
+        uint32_t* buffer = buffer_;
+        int width = width_;
+        // Bands of 128 rows keep the per-band hand-off small next to the fill.
+        parallelForRows(0, height_, 128, [=](int y0, int y1) {
+            std::fill_n(buffer + (size_t)y0 * width, (size_t)(y1 - y0) * width, color);
+        });
     }
     
     void Canvas::setPixel(int x, int y, uint32_t color) {
@@ -0,0 +1,280 @@
+#include "../../include/fern/core/dynamic_resolution.hpp"
+#include "../../include/fern/core/canvas.hpp"
+#include "../../include/fern/core/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace Fern {
+    namespace {
+        const float SCALE_LEVELS[] = {1.0f, 0.75f, 0.5f};
+        const int LEVEL_COUNT = sizeof(SCALE_LEVELS) / sizeof(SCALE_LEVELS[0]);
+
+        // Frames to wait after a change before judging the new scale.
+        const int SETTLE_FRAMES = 30;
+        // Only scale up when the larger frame is expected to leave this much
+        // of the budget unused.
+        const double HEADROOM = 0.8;
+        const double AVERAGE_WEIGHT = 0.1;
+
+        // Per-column source positions for the current internal/presented pair.
+        struct Mapping {
+            int srcWidth = 0, srcHeight = 0;
+            int dstWidth = 0, dstHeight = 0;
+            std::vector<int> nearest;
+            std::vector<int> column0;
+            std::vector<int> column1;
+            std::vector<uint16_t> weights;      // per column, repeated for 4 channels
+        };
+
+        struct State {
+            bool enabled = false;
+            double targetMs = 1000.0 / 60.0;
+            float minimumScale = 0.5f;
+            UpscaleFilter filter = UpscaleFilter::Bilinear;
+
+            int level = 0;
+            double averageMs = 0.0;
+            bool hasAverage = false;
+            int framesSinceChange = 0;
+
+            Canvas* presented = nullptr;
+            Canvas internal{nullptr, 0, 0};
+            std::vector<uint32_t> pixels;
+            Mapping mapping;
+        };
+
+        State& state() {
+            static State instance;
+            return instance;
+        }
+
+        // Maps destination index i to a source position, pixel centers aligned.
+        void sourcePosition(int i, int srcSize, int dstSize, int& i0, int& i1, int& weight) {
+            double s = (i + 0.5) * srcSize / dstSize - 0.5;
+            if (s <= 0.0) {
+                i0 = i1 = 0;
+                weight = 0;
+                return;
+            }
+            i0 = std::min((int)s, srcSize - 1);
+            i1 = std::min(i0 + 1, srcSize - 1);
+            weight = (int)((s - i0) * 256.0 + 0.5);
+        }
+
+        void updateMapping(Mapping& m, int sw, int sh, int dw, int dh) {
+            if (m.srcWidth == sw && m.srcHeight == sh && m.dstWidth == dw && m.dstHeight == dh) return;
+            m.srcWidth = sw;
+            m.srcHeight = sh;
+            m.dstWidth = dw;
+            m.dstHeight = dh;
+            m.nearest.resize(dw);
+            m.column0.resize(dw);
+            m.column1.resize(dw);
+            m.weights.resize((size_t)dw * 4);
+            for (int x = 0; x < dw; ++x) {
+                m.nearest[x] = std::min((int)((x + 0.5) * sw / dw), sw - 1);
+                int weight;
+                sourcePosition(x, sw, dw, m.column0[x], m.column1[x], weight);
+                std::fill_n(m.weights.data() + (size_t)x * 4, 4, (uint16_t)weight);
+            }
+        }
+
+        // Two channels per 32-bit lane (0x00FF00FF mask), weight in [0, 256].
+        inline uint32_t lerpPixel(uint32_t a, uint32_t b, uint32_t weight) {
+            uint32_t inverse = 256 - weight;
+            uint32_t rb = ((a & 0x00FF00FF) * inverse + (b & 0x00FF00FF) * weight) >> 8;
+            uint32_t ag = ((a >> 8) & 0x00FF00FF) * inverse + ((b >> 8) & 0x00FF00FF) * weight;
+            return (rb & 0x00FF00FF) | (ag & 0xFF00FF00);
+        }
+
+#ifdef __SSE2__
+        // Channels widened to 16 bits: (a * (256 - w) + b * w) >> 8.
+        inline __m128i lerp16(__m128i a, __m128i b, __m128i weight) {
+            __m128i inverse = _mm_sub_epi16(_mm_set1_epi16(256), weight);
+            return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(a, inverse), _mm_mullo_epi16(b, weight)), 8);
+        }
+
+        inline __m128i gather(const uint32_t* row, const int* columns) {
+            return _mm_setr_epi32((int)row[columns[0]], (int)row[columns[1]],
+                                  (int)row[columns[2]], (int)row[columns[3]]);
+        }
+#endif
+
+        void upscaleNearest(const Canvas& src, Canvas& dst) {
+            const Mapping& m = state().mapping;
+            const uint32_t* source = src.getBuffer();
+            uint32_t* target = dst.getBuffer();
+            int sw = m.srcWidth, sh = m.srcHeight, dw = m.dstWidth, dh = m.dstHeight;
+            const int* columns = m.nearest.data();
+
+            parallelForRows(0, dh, 32, [=](int y0, int y1) {
+                int previous = -1;
+                for (int y = y0; y < y1; ++y) {
+                    int sy = std::min((int)((y + 0.5) * sh / dh), sh - 1);
+                    uint32_t* out = target + (size_t)y * dw;
+                    if (sy == previous) {
+                        // Rows repeat when upscaling; copy the one just built.
+                        std::memcpy(out, out - dw, (size_t)dw * sizeof(uint32_t));
+                        continue;
+                    }
+                    const uint32_t* row = source + (size_t)sy * sw;
+                    for (int x = 0; x < dw; ++x) {
+                        out[x] = row[columns[x]];
+                    }
+                    previous = sy;
+                }
+            });
+        }
+
+        void upscaleBilinear(const Canvas& src, Canvas& dst) {
+            const Mapping& m = state().mapping;
+            const uint32_t* source = src.getBuffer();
+            uint32_t* target = dst.getBuffer();
+            int sw = m.srcWidth, sh = m.srcHeight, dw = m.dstWidth, dh = m.dstHeight;
+            const int* column0 = m.column0.data();
+            const int* column1 = m.column1.data();
+            const uint16_t* weights = m.weights.data();
+
+            parallelForRows(0, dh, 32, [=](int y0, int y1) {
+                for (int y = y0; y < y1; ++y) {
+                    int row0, row1, wy;
+                    sourcePosition(y, sh, dh, row0, row1, wy);
+                    const uint32_t* top = source + (size_t)row0 * sw;
+                    const uint32_t* bottom = source + (size_t)row1 * sw;
+                    uint32_t* out = target + (size_t)y * dw;
+                    int x = 0;
+#ifdef __SSE2__
+                    __m128i zero = _mm_setzero_si128();
+                    __m128i vertical = _mm_set1_epi16((short)wy);
+                    for (; x + 4 <= dw; x += 4) {
+                        __m128i wLow = _mm_loadu_si128((const __m128i*)(weights + (size_t)x * 4));
+                        __m128i wHigh = _mm_loadu_si128((const __m128i*)(weights + (size_t)x * 4 + 8));
+                        __m128i a = gather(top, column0 + x), b = gather(top, column1 + x);
+                        __m128i c = gather(bottom, column0 + x), d = gather(bottom, column1 + x);
+
+                        __m128i topLow = lerp16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero), wLow);
+                        __m128i topHigh = lerp16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero), wHigh);
+                        __m128i bottomLow = lerp16(_mm_unpacklo_epi8(c, zero), _mm_unpacklo_epi8(d, zero), wLow);
+                        __m128i bottomHigh = lerp16(_mm_unpackhi_epi8(c, zero), _mm_unpackhi_epi8(d, zero), wHigh);
+
+                        __m128i low = lerp16(topLow, bottomLow, vertical);
+                        __m128i high = lerp16(topHigh, bottomHigh, vertical);
+                        _mm_storeu_si128((__m128i*)(out + x), _mm_packus_epi16(low, high));
+                    }
+#endif
+                    for (; x < dw; ++x) {
+                        uint32_t wx = weights[(size_t)x * 4];
+                        uint32_t upper = lerpPixel(top[column0[x]], top[column1[x]], wx);
+                        uint32_t lower = lerpPixel(bottom[column0[x]], bottom[column1[x]], wx);
+                        out[x] = lerpPixel(upper, lower, (uint32_t)wy);
+                    }
+                }
+            });
+        }
+    }
+
+    void DynamicResolution::setEnabled(bool enabled) {
+        State& s = state();
+        s.enabled = enabled;
+        s.level = 0;
+        s.hasAverage = false;
+        s.framesSinceChange = 0;
+    }
+
+    bool DynamicResolution::isEnabled() {
+        return state().enabled;
+    }
+
+    void DynamicResolution::setTargetFrameTime(double milliseconds) {
+        state().targetMs = milliseconds;
+    }
+
+    void DynamicResolution::setMinimumScale(float scale) {
+        State& s = state();
+        s.minimumScale = scale;
+        while (s.level > 0 && SCALE_LEVELS[s.level] < scale) {
+            s.level--;
+        }
+    }
+
+    void DynamicResolution::setFilter(UpscaleFilter filter) {
+        state().filter = filter;
+    }
+
+    float DynamicResolution::getScale() {
+        const State& s = state();
+        return s.enabled ? SCALE_LEVELS[s.level] : 1.0f;
+    }
+
+    void DynamicResolution::beginFrame() {
+        State& s = state();
+        if (!s.enabled || s.level == 0 || !globalCanvas) return;
+
+        float scale = SCALE_LEVELS[s.level];
+        int width = std::max(1, (int)std::lround(globalCanvas->getWidth() * scale));
+        int height = std::max(1, (int)std::lround(globalCanvas->getHeight() * scale));
+        if (s.internal.getWidth() != width || s.internal.getHeight() != height) {
+            // The previous image is kept only at the same size; apps that do
+            // not clear each frame start from black after a change.
+            s.pixels.assign((size_t)width * height, 0xFF000000);
+            s.internal = Canvas(s.pixels.data(), width, height);
+        }
+
+        s.presented = globalCanvas;
+        globalCanvas = &s.internal;
+    }
+
+    void DynamicResolution::endFrame() {
+        State& s = state();
+        if (!s.presented) return;
+
+        globalCanvas = s.presented;
+        s.presented = nullptr;
+
+        updateMapping(s.mapping, s.internal.getWidth(), s.internal.getHeight(),
+                      globalCanvas->getWidth(), globalCanvas->getHeight());
+        if (s.filter == UpscaleFilter::Nearest) {
+            upscaleNearest(s.internal, *globalCanvas);
+        } else {
+            upscaleBilinear(s.internal, *globalCanvas);
+        }
+    }
+
+    void DynamicResolution::recordFrameTime(double milliseconds) {
+        State& s = state();
+        if (!s.enabled) return;
+
+        s.averageMs = s.hasAverage ? s.averageMs + (milliseconds - s.averageMs) * AVERAGE_WEIGHT
+                                   : milliseconds;
+        s.hasAverage = true;
+        if (++s.framesSinceChange < SETTLE_FRAMES) return;
+
+        int level = s.level;
+        if (s.averageMs > s.targetMs) {
+            if (level + 1 < LEVEL_COUNT && SCALE_LEVELS[level + 1] >= s.minimumScale) {
+                level++;
+            }
+        } else if (level > 0) {
+            // Estimate the larger frame from the pixel count; the part of the
+            // frame that does not scale makes this estimate conservative.
+            float ratio = SCALE_LEVELS[level - 1] / SCALE_LEVELS[level];
+            if (s.averageMs * ratio * ratio < s.targetMs * HEADROOM) {
+                level--;
+            }
+        }
+
+        if (level != s.level) {
+            float ratio = SCALE_LEVELS[level] / SCALE_LEVELS[s.level];
+            s.averageMs *= ratio * ratio;
+            s.level = level;
+            s.framesSinceChange = 0;
+        }
+    }
+}
@@ -1,6 +1,8 @@
 #include "../../include/fern/fern.hpp"
 #include "../../include/fern/core/input.hpp"
 #include "../../include/fern/core/widget_manager.hpp"
+#include "../../include/fern/core/signal_queue.hpp"
+#include "../../include/fern/core/dynamic_resolution.hpp"
 #include <emscripten.h>
 #include <functional>
 
@@ -35,11 +37,17 @@ namespace Fern {
     
     void startRenderLoop() {
         emscripten_set_main_loop([]() {
+            double frameStart = emscripten_get_now();
+            Input::pollEvents();
+            SignalQueue::dispatch();
+            
+            DynamicResolution::beginFrame();
             if (drawCallback) {
                 drawCallback();
             }
+            DynamicResolution::endFrame();
 
-            WidgetManager::getInstance().updateAll(Input::getState());
+            WidgetManager::getInstance().processInput();
             WidgetManager::getInstance().renderAll();
             
             EM_ASM({
@@ -74,6 +82,7 @@ namespace Fern {
             globalCanvas->getHeight(), globalCanvas->getWidth(), 
             globalCanvas->getBuffer());
             
+            DynamicResolution::recordFrameTime(emscripten_get_now() - frameStart);
             Input::resetEvents();
         }, 0, 1);
     }
@@ -1,25 +1,101 @@
 #include "../../include/fern/core/input.hpp"
+#include "../../include/fern/core/spsc_queue.hpp"
+#include <atomic>
+#include <chrono>
 
 namespace Fern {
     InputState Input::state_ = {};
+    InputState Input::frameStart_ = {};
+    std::vector<InputEvent> Input::events_;
+    
+    static SpscQueue<InputEvent, 1024> pendingEvents;
+    static std::atomic<size_t> droppedEvents{0};
+    
+    // Producer-side view of the pointer, used to stamp button events.
+    static int producerX = 0;
+    static int producerY = 0;
+    
+    static double now() {
+        using namespace std::chrono;
+        return duration<double, std::milli>(steady_clock::now().time_since_epoch()).count();
+    }
+    
+    static void pushEvent(InputEventType type, int x, int y) {
+        InputEvent event;
+        event.type = type;
+        event.x = x;
+        event.y = y;
+        event.timestamp = now();
+        if (!pendingEvents.push(event)) {
+            droppedEvents.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
     
     InputState& Input::getState() {
         return state_;
     }
     
+    const std::vector<InputEvent>& Input::getEvents() {
+        return events_;
+    }
+    
+    size_t Input::getDroppedEventCount() {
+        return droppedEvents.load(std::memory_order_relaxed);
+    }
+    
     void Input::resetEvents() {
         state_.mouseClicked = false;
+        events_.clear();
+    }
+    
+    void Input::pollEvents() {
+        frameStart_ = state_;
+        pendingEvents.drain([](const InputEvent& event) {
+            switch (event.type) {
+                case InputEventType::Move:
+                    if (event.x == state_.mouseX && event.y == state_.mouseY) return;
+                    state_.mouseX = event.x;
+                    state_.mouseY = event.y;
+                    break;
+                case InputEventType::Down:
+                    if (state_.mouseDown) return;
+                    state_.mouseDown = true;
+                    state_.mouseClicked = true;
+                    events_.push_back(event);
+                    events_.push_back(event);
+                    events_.back().type = InputEventType::Click;
+                    return;
+                case InputEventType::Up:
+                    if (!state_.mouseDown) return;
+                    state_.mouseDown = false;
+                    break;
+                case InputEventType::Click:
+                    return;
+            }
+            events_.push_back(event);
+        });
+    }
+    
+    void Input::coalesceMoves(std::vector<InputEvent>& events) {
+        size_t out = 0;
+        for (size_t i = 0; i < events.size(); ++i) {
+            if (out > 0 && events[i].type == InputEventType::Move &&
+                events[out - 1].type == InputEventType::Move) {
+                events[out - 1] = events[i];
+                continue;
+            }
+            events[out++] = events[i];
+        }
+        events.resize(out);
     }
     
     void Input::updateMousePosition(int x, int y) {
-        state_.mouseX = x;
-        state_.mouseY = y;
+        producerX = x;
+        producerY = y;
+        pushEvent(InputEventType::Move, x, y);
     }
     
     void Input::updateMouseButton(bool down) {
-        if (!state_.mouseDown && down) {
-            state_.mouseClicked = true;
-        }
-        state_.mouseDown = down;
+        pushEvent(down ? InputEventType::Down : InputEventType::Up, producerX, producerY);
     }
-}
\ No newline at end of file
+}
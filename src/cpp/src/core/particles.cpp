@@ -0,0 +1,330 @@
+#include "../../include/fern/core/particles.hpp"
+#include "../../include/fern/core/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace Fern {
+    namespace {
+        // Particles per parallel chunk when integrating.
+        const int INTEGRATE_GRAIN = 4096;
+
+        template <typename T>
+        void permute(std::vector<T>& values, const std::vector<uint32_t>& order, std::vector<T>& scratch) {
+            scratch.resize(values.size());
+            for (size_t i = 0; i < order.size(); ++i) {
+                scratch[i] = values[order[i]];
+            }
+            values.swap(scratch);
+        }
+
+        // Constants of the force kernel, shared by the vector and scalar paths.
+        struct Kernel {
+            float width, height;
+            float halfWidth, halfHeight;
+            bool wrap;
+            float radiusSquared;
+            float minDistance;
+            float sweetSpot;
+            float inverseSweet;
+            float inverseOuter;
+            float strength;
+        };
+
+        inline float pairForce(const Kernel& k, float distance, float attraction) {
+            if (distance < k.minDistance) return -1.0f;
+            if (distance < k.sweetSpot) return attraction * (distance * k.inverseSweet - 1.0f);
+            return attraction * (1.0f - (distance - k.sweetSpot) * k.inverseOuter);
+        }
+    }
+
+    ParticleSystem::ParticleSystem(float worldWidth, float worldHeight)
+        : worldWidth_(worldWidth), worldHeight_(worldHeight) {}
+
+    void ParticleSystem::setRules(const ParticleRules& rules) {
+        rules_ = rules;
+        rules_.typeCount = std::max(rules_.typeCount, 1);
+        rules_.attraction.resize((size_t)rules_.typeCount * rules_.typeCount, 0.0f);
+        columns_ = rows_ = 0;
+    }
+
+    void ParticleSystem::setAttraction(int type, int otherType, float value) {
+        if (type < 0 || type >= rules_.typeCount || otherType < 0 || otherType >= rules_.typeCount) return;
+        rules_.attraction[(size_t)type * rules_.typeCount + otherType] = value;
+    }
+
+    void ParticleSystem::resize(float worldWidth, float worldHeight) {
+        worldWidth_ = worldWidth;
+        worldHeight_ = worldHeight;
+        columns_ = rows_ = 0;
+    }
+
+    void ParticleSystem::add(float x, float y, float vx, float vy, int type, float size) {
+        x_.push_back(x);
+        y_.push_back(y);
+        vx_.push_back(vx);
+        vy_.push_back(vy);
+        type_.push_back(std::min(std::max(type, 0), rules_.typeCount - 1));
+        size_.push_back(size);
+    }
+
+    void ParticleSystem::clear() {
+        x_.clear();
+        y_.clear();
+        vx_.clear();
+        vy_.clear();
+        type_.clear();
+        size_.clear();
+    }
+
+    void ParticleSystem::reserve(size_t count) {
+        x_.reserve(count);
+        y_.reserve(count);
+        vx_.reserve(count);
+        vy_.reserve(count);
+        type_.reserve(count);
+        size_.reserve(count);
+    }
+
+    void ParticleSystem::buildGrid() {
+        float radius = rules_.interactionRadius;
+        int columns = radius > 0.0f ? std::max(1, (int)(worldWidth_ / radius)) : 1;
+        int rows = radius > 0.0f ? std::max(1, (int)(worldHeight_ / radius)) : 1;
+        int cellCount = columns * rows;
+
+        if (columns != columns_ || rows != rows_) {
+            columns_ = columns;
+            rows_ = rows;
+            neighbors_.assign((size_t)cellCount * 9, 0);
+            neighborCount_.assign(cellCount, 0);
+            for (int cy = 0; cy < rows; ++cy) {
+                for (int cx = 0; cx < columns; ++cx) {
+                    int cell = cy * columns + cx;
+                    int* list = &neighbors_[(size_t)cell * 9];
+                    int count = 0;
+                    for (int dy = -1; dy <= 1; ++dy) {
+                        for (int dx = -1; dx <= 1; ++dx) {
+                            int nx = cx + dx, ny = cy + dy;
+                            if (rules_.wrapEdges) {
+                                nx = (nx + columns) % columns;
+                                ny = (ny + rows) % rows;
+                            } else if (nx < 0 || nx >= columns || ny < 0 || ny >= rows) {
+                                continue;
+                            }
+                            int neighbor = ny * columns + nx;
+                            // Small grids wrap onto the same cell more than once.
+                            if (std::find(list, list + count, neighbor) == list + count) {
+                                list[count++] = neighbor;
+                            }
+                        }
+                    }
+                    neighborCount_[cell] = (uint8_t)count;
+                }
+            }
+        }
+
+        // Counting sort by cell.
+        size_t count = x_.size();
+        float cellWidth = worldWidth_ / columns, cellHeight = worldHeight_ / rows;
+        cellOf_.resize(count);
+        cellStart_.assign((size_t)cellCount + 1, 0);
+        for (size_t i = 0; i < count; ++i) {
+            int cx = std::min(std::max((int)(x_[i] / cellWidth), 0), columns - 1);
+            int cy = std::min(std::max((int)(y_[i] / cellHeight), 0), rows - 1);
+            cellOf_[i] = (uint32_t)(cy * columns + cx);
+            cellStart_[cellOf_[i] + 1]++;
+        }
+        for (int c = 0; c < cellCount; ++c) {
+            cellStart_[c + 1] += cellStart_[c];
+        }
+        order_.resize(count);
+        std::vector<uint32_t> next(cellStart_.begin(), cellStart_.end() - 1);
+        for (size_t i = 0; i < count; ++i) {
+            order_[next[cellOf_[i]]++] = (uint32_t)i;
+        }
+
+        permute(x_, order_, scratch_);
+        permute(y_, order_, scratch_);
+        permute(vx_, order_, scratch_);
+        permute(vy_, order_, scratch_);
+        permute(size_, order_, scratch_);
+        permute(type_, order_, scratchTypes_);
+    }
+
+    void ParticleSystem::computeForces(size_t cellBegin, size_t cellEnd) {
+        const ParticleRules& r = rules_;
+        Kernel k;
+        k.width = worldWidth_;
+        k.height = worldHeight_;
+        k.halfWidth = worldWidth_ * 0.5f;
+        k.halfHeight = worldHeight_ * 0.5f;
+        k.wrap = r.wrapEdges;
+        k.radiusSquared = r.interactionRadius * r.interactionRadius;
+        k.minDistance = r.minDistance;
+        k.sweetSpot = r.interactionRadius * 0.5f;
+        k.inverseSweet = 1.0f / k.sweetSpot;
+        k.inverseOuter = 1.0f / (r.interactionRadius - k.sweetSpot);
+        k.strength = r.forceStrength;
+
+        const float* xs = x_.data();
+        const float* ys = y_.data();
+        const int* types = type_.data();
+
+#ifdef __SSE2__
+        __m128 width = _mm_set1_ps(k.width), height = _mm_set1_ps(k.height);
+        __m128 halfWidth = _mm_set1_ps(k.halfWidth), halfHeight = _mm_set1_ps(k.halfHeight);
+        __m128 negHalfWidth = _mm_set1_ps(-k.halfWidth), negHalfHeight = _mm_set1_ps(-k.halfHeight);
+        __m128 radiusSquared = _mm_set1_ps(k.radiusSquared);
+        __m128 minSquared = _mm_set1_ps(0.01f);
+        __m128 minDistance = _mm_set1_ps(k.minDistance);
+        __m128 sweetSpot = _mm_set1_ps(k.sweetSpot);
+        __m128 inverseSweet = _mm_set1_ps(k.inverseSweet);
+        __m128 inverseOuter = _mm_set1_ps(k.inverseOuter);
+        __m128 strength = _mm_set1_ps(k.strength);
+        __m128 one = _mm_set1_ps(1.0f), minusOne = _mm_set1_ps(-1.0f);
+#endif
+
+        for (size_t cell = cellBegin; cell < cellEnd; ++cell) {
+            const int* neighbors = &neighbors_[cell * 9];
+            int neighborCount = neighborCount_[cell];
+
+            for (uint32_t i = cellStart_[cell]; i < cellStart_[cell + 1]; ++i) {
+                float xi = xs[i], yi = ys[i];
+                const float* attraction = &r.attraction[(size_t)types[i] * r.typeCount];
+                float fx = 0.0f, fy = 0.0f;
+
+                for (int n = 0; n < neighborCount; ++n) {
+                    uint32_t j = cellStart_[neighbors[n]];
+                    uint32_t end = cellStart_[neighbors[n] + 1];
+#ifdef __SSE2__
+                    __m128 vxi = _mm_set1_ps(xi), vyi = _mm_set1_ps(yi);
+                    __m128 sumX = _mm_setzero_ps(), sumY = _mm_setzero_ps();
+
+                    for (; j + 4 <= end; j += 4) {
+                        __m128 dx = _mm_sub_ps(_mm_loadu_ps(xs + j), vxi);
+                        __m128 dy = _mm_sub_ps(_mm_loadu_ps(ys + j), vyi);
+                        if (k.wrap) {
+                            dx = _mm_sub_ps(dx, _mm_and_ps(_mm_cmpgt_ps(dx, halfWidth), width));
+                            dx = _mm_add_ps(dx, _mm_and_ps(_mm_cmplt_ps(dx, negHalfWidth), width));
+                            dy = _mm_sub_ps(dy, _mm_and_ps(_mm_cmpgt_ps(dy, halfHeight), height));
+                            dy = _mm_add_ps(dy, _mm_and_ps(_mm_cmplt_ps(dy, negHalfHeight), height));
+                        }
+                        __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+                        __m128 inRange = _mm_and_ps(_mm_cmplt_ps(d2, radiusSquared), _mm_cmpgt_ps(d2, minSquared));
+                        if (_mm_movemask_ps(inRange) == 0) continue;
+
+                        __m128 d = _mm_sqrt_ps(d2);
+                        __m128 attract = _mm_setr_ps(attraction[types[j]], attraction[types[j + 1]],
+                                                     attraction[types[j + 2]], attraction[types[j + 3]]);
+                        __m128 inner = _mm_mul_ps(attract, _mm_sub_ps(_mm_mul_ps(d, inverseSweet), one));
+                        __m128 outer = _mm_mul_ps(attract, _mm_sub_ps(one,
+                            _mm_mul_ps(_mm_sub_ps(d, sweetSpot), inverseOuter)));
+                        __m128 isInner = _mm_cmplt_ps(d, sweetSpot);
+                        __m128 force = _mm_or_ps(_mm_and_ps(isInner, inner), _mm_andnot_ps(isInner, outer));
+                        __m128 tooClose = _mm_cmplt_ps(d, minDistance);
+                        force = _mm_or_ps(_mm_and_ps(tooClose, minusOne), _mm_andnot_ps(tooClose, force));
+
+                        // Out-of-range lanes may hold inf or NaN; the mask clears them.
+                        __m128 scale = _mm_and_ps(inRange, _mm_div_ps(_mm_mul_ps(force, strength), d));
+                        sumX = _mm_add_ps(sumX, _mm_and_ps(inRange, _mm_mul_ps(dx, scale)));
+                        sumY = _mm_add_ps(sumY, _mm_and_ps(inRange, _mm_mul_ps(dy, scale)));
+                    }
+
+                    float lanes[4];
+                    _mm_storeu_ps(lanes, sumX);
+                    fx += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+                    _mm_storeu_ps(lanes, sumY);
+                    fy += (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+                    for (; j < end; ++j) {
+                        float dx = xs[j] - xi, dy = ys[j] - yi;
+                        if (k.wrap) {
+                            if (dx > k.halfWidth) dx -= k.width;
+                            if (dx < -k.halfWidth) dx += k.width;
+                            if (dy > k.halfHeight) dy -= k.height;
+                            if (dy < -k.halfHeight) dy += k.height;
+                        }
+                        float d2 = dx * dx + dy * dy;
+                        if (d2 >= k.radiusSquared || d2 <= 0.01f) continue;
+
+                        float d = std::sqrt(d2);
+                        float scale = pairForce(k, d, attraction[types[j]]) * k.strength / d;
+                        fx += dx * scale;
+                        fy += dy * scale;
+                    }
+                }
+
+                fx_[i] = fx;
+                fy_[i] = fy;
+            }
+        }
+    }
+
+    void ParticleSystem::integrate(size_t begin, size_t end) {
+        const ParticleRules& r = rules_;
+        float damping = 1.0f - r.friction;
+        float maxSpeed = r.maxSpeed;
+        float left = r.wallMargin, top = r.wallMargin;
+        float right = worldWidth_ - r.wallMargin - 1.0f;
+        float bottom = worldHeight_ - r.wallMargin - 1.0f;
+
+        for (size_t i = begin; i < end; ++i) {
+            float vx = (vx_[i] + fx_[i]) * damping;
+            float vy = (vy_[i] + fy_[i]) * damping;
+            float speed = std::sqrt(vx * vx + vy * vy);
+            if (speed > maxSpeed) {
+                vx *= maxSpeed / speed;
+                vy *= maxSpeed / speed;
+            }
+
+            float x = x_[i] + vx;
+            float y = y_[i] + vy;
+            if (r.wrapEdges) {
+                if (x < 0) x += worldWidth_;
+                if (x >= worldWidth_) x -= worldWidth_;
+                if (y < 0) y += worldHeight_;
+                if (y >= worldHeight_) y -= worldHeight_;
+            } else {
+                if (x < left) {
+                    x = left;
+                    vx *= -r.wallBounce;
+                } else if (x >= right + 1.0f) {
+                    x = right;
+                    vx *= -r.wallBounce;
+                }
+                if (y < top) {
+                    y = top;
+                    vy *= -r.wallBounce;
+                } else if (y >= bottom + 1.0f) {
+                    y = bottom;
+                    vy *= -r.wallBounce;
+                }
+            }
+
+            x_[i] = x;
+            y_[i] = y;
+            vx_[i] = vx;
+            vy_[i] = vy;
+        }
+    }
+
+    void ParticleSystem::step() {
+        if (x_.empty()) return;
+
+        buildGrid();
+        fx_.resize(x_.size());
+        fy_.resize(x_.size());
+
+        // Cells vary a lot in population; one cell per chunk lets the pool
+        // balance them.
+        parallelFor(0, columns_ * rows_, 1, [this](int first, int last) {
+            computeForces((size_t)first, (size_t)last);
+        });
+        parallelFor(0, (int)x_.size(), INTEGRATE_GRAIN, [this](int first, int last) {
+            integrate((size_t)first, (size_t)last);
+        });
+    }
+}
@@ -0,0 +1,55 @@
+#include "../../include/fern/core/signal_queue.hpp"
+
+namespace Fern {
+    std::atomic<SignalQueue::Node*> SignalQueue::head_{nullptr};
+    uint64_t SignalQueue::dispatchCount_ = 0;
+
+    void SignalQueue::push(Node* node) {
+        Node* head = head_.load(std::memory_order_relaxed);
+        do {
+            node->next = head;
+        } while (!head_.compare_exchange_weak(head, node,
+                     std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    size_t SignalQueue::dispatch() {
+        // Taking the whole stack at once leaves producers free to keep pushing
+        // and avoids ABA: nodes are never popped individually.
+        Node* node = head_.exchange(nullptr, std::memory_order_acquire);
+        if (!node) return 0;
+
+        // The stack is newest first. Walk it once to drop dead and superseded
+        // emissions while reversing the survivors into FIFO order.
+        uint64_t dispatchId = ++dispatchCount_;
+        Node* fifo = nullptr;
+        while (node) {
+            Node* next = node->next;
+            Link* link = node->link;
+            bool keep = link->target != nullptr;
+            if (keep && node->coalesces()) {
+                keep = link->seenInDispatch != dispatchId;
+                link->seenInDispatch = dispatchId;
+            }
+            if (keep) {
+                node->next = fifo;
+                fifo = node;
+            } else {
+                node->recycle();
+            }
+            node = next;
+        }
+
+        size_t delivered = 0;
+        while (fifo) {
+            Node* next = fifo->next;
+            // A slot run earlier in this batch may have destroyed the signal.
+            if (fifo->link->target) {
+                fifo->deliver();
+                delivered++;
+            }
+            fifo->recycle();
+            fifo = next;
+        }
+        return delivered;
+    }
+}
@@ -0,0 +1,184 @@
+#include "../../include/fern/core/thread_pool.hpp"
+#include <deque>
+#include <memory>
+#include <vector>
+
+#if FERN_THREADS
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
+
+namespace Fern {
+    struct Task {
+        std::function<void()> fn;
+        TaskGroup* group;
+    };
+
+#if FERN_THREADS
+    struct Worker {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    // Index of the worker running on this thread, -1 for other threads.
+    static thread_local int currentWorker = -1;
+
+    struct ThreadPool::Impl {
+        std::vector<std::unique_ptr<Worker>> workers;
+        std::vector<std::thread> threads;
+        std::atomic<int> queued{0};
+        std::atomic<unsigned> nextVictim{0};
+        std::mutex sleepMutex;
+        std::condition_variable wake;
+    };
+#else
+    struct ThreadPool::Impl {
+        std::vector<int> workers;
+    };
+#endif
+
+    ThreadPool& ThreadPool::getInstance() {
+        static ThreadPool* pool = new ThreadPool();
+        return *pool;
+    }
+
+    int ThreadPool::getWorkerCount() const {
+        return (int)impl_->workers.size();
+    }
+
+    ThreadPool::ThreadPool() : impl_(new Impl()) {
+#if FERN_THREADS
+        unsigned cores = std::thread::hardware_concurrency();
+        int count = cores > 1 ? (int)cores - 1 : 0;
+        for (int i = 0; i < count; ++i) {
+            impl_->workers.emplace_back(new Worker());
+        }
+        for (int i = 0; i < count; ++i) {
+            impl_->threads.emplace_back([this, i]() {
+                currentWorker = i;
+                for (;;) {
+                    if (runPendingTask()) continue;
+                    std::unique_lock<std::mutex> lock(impl_->sleepMutex);
+                    impl_->wake.wait(lock, [this]() { return impl_->queued.load() > 0; });
+                }
+            });
+            impl_->threads.back().detach();
+        }
+#endif
+    }
+
+    void ThreadPool::submit(TaskGroup& group, std::function<void()> task) {
+#if FERN_THREADS
+        int count = (int)impl_->workers.size();
+        int target = currentWorker >= 0 ? currentWorker
+                                        : (int)(impl_->nextVictim.fetch_add(1) % count);
+        Worker& worker = *impl_->workers[target];
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.tasks.push_back(Task{std::move(task), &group});
+        }
+        impl_->queued.fetch_add(1);
+        {
+            // Taking the lock orders this wake-up after a sleeper's check.
+            std::lock_guard<std::mutex> lock(impl_->sleepMutex);
+        }
+        impl_->wake.notify_one();
+#else
+        (void)group;
+        task();
+#endif
+    }
+
+    bool ThreadPool::runPendingTask() {
+#if FERN_THREADS
+        if (impl_->queued.load(std::memory_order_relaxed) == 0) return false;
+
+        int count = (int)impl_->workers.size();
+        Task task;
+        bool found = false;
+
+        // Own work first, newest first (LIFO keeps caches warm)...
+        if (currentWorker >= 0) {
+            Worker& own = *impl_->workers[currentWorker];
+            std::lock_guard<std::mutex> lock(own.mutex);
+            if (!own.tasks.empty()) {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                found = true;
+            }
+        }
+        // ...then steal the oldest task of another worker.
+        unsigned start = impl_->nextVictim.fetch_add(1);
+        for (int i = 0; i < count && !found; ++i) {
+            int victim = (int)((start + i) % count);
+            if (victim == currentWorker) continue;
+            Worker& other = *impl_->workers[victim];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (!other.tasks.empty()) {
+                task = std::move(other.tasks.front());
+                other.tasks.pop_front();
+                found = true;
+            }
+        }
+        if (!found) return false;
+
+        impl_->queued.fetch_sub(1);
+        task.fn();
+        task.group->pending_.fetch_sub(1, std::memory_order_release);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void ThreadPool::forEachChunk(int chunkCount, ChunkFunction fn, void* context) {
+        if (chunkCount <= 0) return;
+
+        struct Shared {
+            std::atomic<int> next{0};
+            int count;
+            ChunkFunction fn;
+            void* context;
+        } shared;
+        shared.count = chunkCount;
+        shared.fn = fn;
+        shared.context = context;
+
+        auto drain = [&shared]() {
+            int chunk;
+            while ((chunk = shared.next.fetch_add(1)) < shared.count) {
+                shared.fn(shared.context, chunk);
+            }
+        };
+
+        int helpers = std::min(getWorkerCount(), chunkCount - 1);
+        TaskGroup group;
+        for (int i = 0; i < helpers; ++i) {
+            group.run(drain);
+        }
+        drain();
+        group.wait();
+    }
+
+    void TaskGroup::run(std::function<void()> task) {
+        ThreadPool& pool = ThreadPool::getInstance();
+        if (pool.getWorkerCount() == 0) {
+            task();
+            return;
+        }
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        pool.submit(*this, std::move(task));
+    }
+
+    void TaskGroup::wait() {
+        ThreadPool& pool = ThreadPool::getInstance();
+        while (pending_.load(std::memory_order_acquire) > 0) {
+            if (!pool.runPendingTask()) {
+#if FERN_THREADS
+                std::this_thread::yield();
+#endif
+            }
+        }
+    }
+}
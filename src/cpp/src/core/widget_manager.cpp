@@ -0,0 +1,319 @@
+#include "../../include/fern/core/widget_manager.hpp"
+#include "../../include/fern/core/canvas.hpp"
+#include "../../include/fern/ui/button.hpp"
+#include "../../include/fern/ui/container.hpp"
+#include <functional>
+#include <typeinfo>
+
+namespace Fern {
+    constexpr int WidgetManager::CELL_SIZE;
+    constexpr int64_t WidgetManager::MAX_GRID_CELLS;
+
+    // The exact-type checks keep devirtualized calls safe: a subclass of
+    // Button may override render() or handleInput().
+    WidgetManager::WidgetKind WidgetManager::classify(const Widget& widget) {
+        if (typeid(widget) == typeid(Button)) return WidgetKind::Button;
+        if (typeid(widget) == typeid(Container)) return WidgetKind::Container;
+        return WidgetKind::Custom;
+    }
+
+    bool WidgetManager::boundsOf(const Entry& entry, Rect& bounds) {
+        switch (entry.kind) {
+            case WidgetKind::Button:
+                return static_cast<const Button*>(entry.widget)->Button::getBounds(bounds);
+            case WidgetKind::Container:
+                return static_cast<const Container*>(entry.widget)->Container::getBounds(bounds);
+            case WidgetKind::Custom:
+                break;
+        }
+        return entry.widget->getBounds(bounds);
+    }
+
+    WidgetHandle WidgetManager::addWidget(std::shared_ptr<Widget> widget) {
+        if (!widget) return WidgetHandle();
+
+        auto existing = slotOf_.find(widget.get());
+        if (existing != slotOf_.end()) {
+            return WidgetHandle{existing->second, slots_[existing->second].generation};
+        }
+
+        uint32_t index;
+        if (!freeSlots_.empty()) {
+            index = freeSlots_.back();
+            freeSlots_.pop_back();
+        } else {
+            index = (uint32_t)slots_.size();
+            slots_.emplace_back();
+        }
+
+        Entry entry;
+        entry.widget = widget.get();
+        entry.slot = index;
+        entry.kind = classify(*widget);
+        
+        Slot& slot = slots_[index];
+        slot.entry = (uint32_t)entries_.size();
+        slot.owner = std::move(widget);
+        slotOf_[entry.widget] = index;
+        entries_.push_back(entry);
+        indexDirty_ = true;
+
+        return WidgetHandle{index, slot.generation};
+    }
+
+    void WidgetManager::removeWidget(WidgetHandle handle) {
+        if (!getWidget(handle)) return;
+
+        Slot& slot = slots_[handle.index];
+        Entry& entry = entries_[slot.entry];
+        slotOf_.erase(entry.widget);
+        entry.widget = nullptr;
+        entry.hot = false;
+
+        removed_.push_back(std::move(slot.owner));
+        slot.owner.reset();
+        slot.generation++;
+        freeSlots_.push_back(handle.index);
+        indexDirty_ = true;
+    }
+
+    void WidgetManager::removeWidget(std::shared_ptr<Widget> widget) {
+        removeWidget(findHandle(widget.get()));
+    }
+
+    Widget* WidgetManager::getWidget(WidgetHandle handle) const {
+        if (handle.index >= slots_.size()) return nullptr;
+        const Slot& slot = slots_[handle.index];
+        if (slot.generation != handle.generation) return nullptr;
+        return slot.owner.get();
+    }
+
+    WidgetHandle WidgetManager::findHandle(const Widget* widget) const {
+        auto found = slotOf_.find(widget);
+        if (found == slotOf_.end()) return WidgetHandle();
+        return WidgetHandle{found->second, slots_[found->second].generation};
+    }
+
+    void WidgetManager::setTicking(WidgetHandle handle, bool ticking) {
+        if (!getWidget(handle)) return;
+        Entry& entry = entries_[slots_[handle.index].entry];
+        if (entry.ticking != ticking) {
+            entry.ticking = ticking;
+            indexDirty_ = true;
+        }
+    }
+
+    void WidgetManager::rebuildIndex() {
+        indexDirty_ = false;
+        cells_.clear();
+        unbounded_.clear();
+        hot_.clear();
+        ticking_.clear();
+        removed_.clear();
+
+        // Drop entries of removed widgets and renumber the survivors.
+        size_t live = 0;
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            if (!entries_[i].widget) continue;
+            entries_[live] = entries_[i];
+            slots_[entries_[live].slot].entry = (uint32_t)live;
+            live++;
+        }
+        entries_.resize(live);
+
+        int64_t minX = 0, minY = 0, maxX = 0, maxY = 0;
+        bool any = false;
+        for (uint32_t i = 0; i < entries_.size(); ++i) {
+            Entry& entry = entries_[i];
+            entry.bounded = boundsOf(entry, entry.bounds) &&
+                            entry.bounds.width > 0 && entry.bounds.height > 0;
+            if (entry.hot) {
+                hot_.push_back(i);
+            }
+            if (entry.ticking) {
+                ticking_.push_back(i);
+            }
+            if (!entry.bounded) {
+                if (entry.kind != WidgetKind::Container) {
+                    unbounded_.push_back(i);
+                }
+                continue;
+            }
+            const Rect& b = entry.bounds;
+            if (!any) {
+                minX = b.x;
+                minY = b.y;
+                maxX = (int64_t)b.x + b.width;
+                maxY = (int64_t)b.y + b.height;
+                any = true;
+            } else {
+                minX = std::min<int64_t>(minX, b.x);
+                minY = std::min<int64_t>(minY, b.y);
+                maxX = std::max<int64_t>(maxX, (int64_t)b.x + b.width);
+                maxY = std::max<int64_t>(maxY, (int64_t)b.y + b.height);
+            }
+        }
+
+        std::reverse(ticking_.begin(), ticking_.end());
+
+        // The pointer never leaves the canvas, so neither does the grid.
+        if (any && globalCanvas) {
+            minX = std::max<int64_t>(minX, 0);
+            minY = std::max<int64_t>(minY, 0);
+            maxX = std::min<int64_t>(maxX, globalCanvas->getWidth());
+            maxY = std::min<int64_t>(maxY, globalCanvas->getHeight());
+            any = minX < maxX && minY < maxY;
+        }
+        int64_t cols = any ? (maxX - minX + CELL_SIZE - 1) / CELL_SIZE : 0;
+        int64_t rows = any ? (maxY - minY + CELL_SIZE - 1) / CELL_SIZE : 0;
+        if (cols * rows > MAX_GRID_CELLS) {
+            for (uint32_t i = 0; i < entries_.size(); ++i) {
+                const Entry& entry = entries_[i];
+                if (entry.bounded && entry.kind != WidgetKind::Container) {
+                    unbounded_.push_back(i);
+                }
+            }
+            cols = rows = 0;
+        }
+
+        gridX_ = (int)minX;
+        gridY_ = (int)minY;
+        gridCols_ = (int)cols;
+        gridRows_ = (int)rows;
+        cells_.resize(gridCols_ * gridRows_);
+        if (cells_.empty()) return;
+
+        for (uint32_t i = 0; i < entries_.size(); ++i) {
+            const Entry& entry = entries_[i];
+            if (!entry.bounded) continue;
+            const Rect& b = entry.bounds;
+            // Widgets past the canvas edge keep the cells that are on it.
+            if ((int64_t)b.x + b.width <= gridX_ || (int64_t)b.y + b.height <= gridY_) continue;
+            int64_t c0 = std::max<int64_t>(((int64_t)b.x - gridX_) / CELL_SIZE, 0);
+            int64_t r0 = std::max<int64_t>(((int64_t)b.y - gridY_) / CELL_SIZE, 0);
+            int64_t c1 = std::min<int64_t>(((int64_t)b.x + b.width - 1 - gridX_) / CELL_SIZE, gridCols_ - 1);
+            int64_t r1 = std::min<int64_t>(((int64_t)b.y + b.height - 1 - gridY_) / CELL_SIZE, gridRows_ - 1);
+            for (int64_t r = r0; r <= r1; ++r) {
+                for (int64_t c = c0; c <= c1; ++c) {
+                    cells_[r * gridCols_ + c].push_back(i);
+                }
+            }
+        }
+    }
+
+    // Widgets that may react to this update: everything without bounds,
+    // ticking widgets, indexed widgets under the pointer, and widgets the
+    // pointer was over last time so they can clear their hover/press state.
+    void WidgetManager::collectCandidates(const InputState& input) {
+        candidates_.assign(unbounded_.begin(), unbounded_.end());
+        candidates_.insert(candidates_.end(), ticking_.begin(), ticking_.end());
+        candidates_.insert(candidates_.end(), hot_.begin(), hot_.end());
+        pointed_.clear();
+
+        int px = input.mouseX - gridX_;
+        int py = input.mouseY - gridY_;
+        if (px >= 0 && py >= 0 && px < gridCols_ * CELL_SIZE && py < gridRows_ * CELL_SIZE) {
+            for (uint32_t i : cells_[(py / CELL_SIZE) * gridCols_ + px / CELL_SIZE]) {
+                if (entries_[i].bounds.contains(input.mouseX, input.mouseY)) {
+                    pointed_.push_back(i);
+                    candidates_.push_back(i);
+                }
+            }
+        }
+
+        std::sort(candidates_.begin(), candidates_.end(), std::greater<uint32_t>());
+        candidates_.erase(std::unique(candidates_.begin(), candidates_.end()), candidates_.end());
+    }
+
+    // Dispatch stops at the first widget that handles the input, so only a
+    // prefix of candidates_ was updated. Widgets below it stay hot until an
+    // update reaches them and they see where the pointer went.
+    void WidgetManager::updateHot(const InputState& input, size_t visited) {
+        hoverPending_ = false;
+        size_t kept = 0;
+        for (uint32_t i : hot_) {
+            Entry& entry = entries_[i];
+            bool skipped = visited < candidates_.size() && i <= candidates_[visited];
+            if (entry.widget && skipped) {
+                hot_[kept++] = i;
+                if (!entry.bounds.contains(input.mouseX, input.mouseY)) {
+                    hoverPending_ = true;
+                }
+            } else {
+                entry.hot = false;
+            }
+        }
+        hot_.resize(kept);
+
+        for (uint32_t i : pointed_) {
+            Entry& entry = entries_[i];
+            if (entry.widget && !entry.hot) {
+                entry.hot = true;
+                hot_.push_back(i);
+            }
+        }
+    }
+
+    void WidgetManager::processInput() {
+        if (indexDirty_) {
+            rebuildIndex();
+        } else if (!Input::hasEvents() && !hoverPending_) {
+            if (!ticking_.empty()) {
+                dispatch(ticking_, Input::getState());
+            }
+            return;
+        }
+        updateAll(Input::getState());
+    }
+
+    void WidgetManager::updateAll(const InputState& input) {
+        if (indexDirty_) {
+            rebuildIndex();
+        }
+        collectCandidates(input);
+        updateHot(input, dispatch(candidates_, input));
+    }
+
+    // Visits targets in the given order until one of them handles the input.
+    // Returns how many targets were visited.
+    size_t WidgetManager::dispatch(const std::vector<uint32_t>& targets, const InputState& input) {
+        bool inputHandled = false;
+        size_t visited = 0;
+        for (uint32_t i : targets) {
+            if (inputHandled) break;
+            visited++;
+            // Re-read the entry every time: handlers may add or remove widgets.
+            Entry entry = entries_[i];
+            if (!entry.widget) continue;
+            switch (entry.kind) {
+                case WidgetKind::Button:
+                    inputHandled = static_cast<Button*>(entry.widget)->Button::handleInput(input);
+                    break;
+                case WidgetKind::Container:
+                    break;
+                case WidgetKind::Custom:
+                    inputHandled = entry.widget->handleInput(input);
+                    break;
+            }
+        }
+        return visited;
+    }
+
+    void WidgetManager::renderAll() {
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            Entry& entry = entries_[i];
+            if (!entry.widget) continue;
+            switch (entry.kind) {
+                case WidgetKind::Button:
+                    static_cast<Button*>(entry.widget)->Button::render();
+                    break;
+                case WidgetKind::Container:
+                    static_cast<Container*>(entry.widget)->Container::render();
+                    break;
+                case WidgetKind::Custom:
+                    entry.widget->render();
+                    break;
+            }
+        }
+    }
+}
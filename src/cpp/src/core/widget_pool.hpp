@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Fern {
+    namespace WidgetPool {
+        // Fixed-size block arena. Blocks are carved out of 64-block chunks and
+        // recycled through a free list, so objects of one type stay packed
+        // together instead of being scattered across the heap.
+        //
+        // Thread-safe: widgets are created on the render thread, but the last
+        // shared_ptr to one may be dropped anywhere, e.g. by a worker that
+        // captured it, and that frees its block.
+        template <size_t Size, size_t Align>
+        class BlockArena {
+        public:
+            // Never destroyed: pooled widgets may outlive static destruction order.
+            static BlockArena& instance() {
+                static BlockArena* arena = new BlockArena();
+                return *arena;
+            }
+
+            void* allocate() {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!free_) {
+                    grow();
+                }
+                Block* block = free_;
+                free_ = block->next;
+                return &block->storage;
+            }
+
+            void deallocate(void* ptr) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                Block* block = static_cast<Block*>(ptr);
+                block->next = free_;
+                free_ = block;
+            }
+
+        private:
+            static constexpr size_t CHUNK_BLOCKS = 64;
+
+            union Block {
+                Block* next;
+                typename std::aligned_storage<Size, Align>::type storage;
+            };
+
+            void grow() {
+                chunks_.emplace_back(new Block[CHUNK_BLOCKS]);
+                Block* chunk = chunks_.back().get();
+                for (size_t i = CHUNK_BLOCKS; i-- > 0;) {
+                    chunk[i].next = free_;
+                    free_ = &chunk[i];
+                }
+            }
+
+            std::mutex mutex_;      // guards chunks_ and free_
+            std::vector<std::unique_ptr<Block[]>> chunks_;
+            Block* free_ = nullptr;
+        };
+
+        // Allocator for std::allocate_shared: the object and its control block
+        // come from a per-type arena.
+        template <typename T>
+        struct Allocator {
+            using value_type = T;
+
+            Allocator() = default;
+            template <typename U>
+            Allocator(const Allocator<U>&) {}
+
+            T* allocate(size_t n) {
+                if (n != 1) {
+                    return std::allocator<T>().allocate(n);
+                }
+                return static_cast<T*>(BlockArena<sizeof(T), alignof(T)>::instance().allocate());
+            }
+
+            void deallocate(T* ptr, size_t n) {
+                if (n != 1) {
+                    std::allocator<T>().deallocate(ptr, n);
+                    return;
+                }
+                BlockArena<sizeof(T), alignof(T)>::instance().deallocate(ptr);
+            }
+
+            template <typename U>
+            bool operator==(const Allocator<U>&) const { return true; }
+            template <typename U>
+            bool operator!=(const Allocator<U>&) const { return false; }
+        };
+
+        template <typename T, typename... Args>
+        std::shared_ptr<T> make(Args&&... args) {
+            return std::allocate_shared<T>(Allocator<T>(), std::forward<Args>(args)...);
+        }
+    }
+}
@@ -0,0 +1,285 @@
+#include "../../include/fern/graphics/layers.hpp"
+#include "../../include/fern/graphics/colors.hpp"
+#include "../../include/fern/core/thread_pool.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace Fern {
+    namespace {
+        // Blends count pixels of src over the opaque dst; opacity in [0, 255].
+        void blendRow(uint32_t* dst, const uint32_t* src, int count, uint32_t opacity) {
+            for (int i = 0; i < count; ++i) {
+                uint32_t pixel = src[i];
+                uint32_t alpha = pixel >> 24;
+                if (opacity != 255) alpha = (alpha * opacity + 127) / 255;
+                if (alpha == 0) continue;
+                dst[i] = alpha == 255 ? pixel : Colors::blendAlpha(dst[i], pixel, alpha) | 0xFF000000;
+            }
+        }
+    }
+
+    constexpr int Compositor::TILE_SIZE;
+
+    Layer::Layer(Compositor& owner, const std::string& name, int width, int height)
+        : owner_(owner), name_(name), pixels_((size_t)width * height, 0),
+          canvas_(pixels_.data(), width, height),
+          columns_((width + Compositor::TILE_SIZE - 1) / Compositor::TILE_SIZE),
+          rows_((height + Compositor::TILE_SIZE - 1) / Compositor::TILE_SIZE) {
+        resetTiles(0);
+    }
+
+    void Layer::setOpacity(float opacity) {
+        opacity = std::min(std::max(opacity, 0.0f), 1.0f);
+        if (opacity == opacity_) return;
+        opacity_ = opacity;
+        owner_.invalidateAll();
+    }
+
+    void Layer::setVisible(bool visible) {
+        if (visible == visible_) return;
+        visible_ = visible;
+        owner_.invalidateAll();
+    }
+
+    void Layer::clear(uint32_t color) {
+        std::fill(pixels_.begin(), pixels_.end(), color);
+        resetTiles(color);
+        owner_.invalidateAll();
+    }
+
+    void Layer::markDirty(const Rect& area) {
+        markTiles(area);
+        owner_.invalidate(area);
+    }
+
+    void Layer::resetTiles(uint32_t color) {
+        // A uniform layer needs one tile, whatever its size.
+        const int size = Compositor::TILE_SIZE;
+        LayerSnapshot::Tile uniform = std::make_shared<const std::vector<uint32_t>>((size_t)size * size, color);
+        saved_.assign((size_t)columns_ * rows_, uniform);
+        changed_.assign(saved_.size(), 0);
+        changedList_.clear();
+    }
+
+    void Layer::markTiles(const Rect& area) {
+        const int size = Compositor::TILE_SIZE;
+        int x0 = std::max(area.x, 0);
+        int y0 = std::max(area.y, 0);
+        int x1 = std::min(area.x + area.width, canvas_.getWidth());
+        int y1 = std::min(area.y + area.height, canvas_.getHeight());
+        if (x0 >= x1 || y0 >= y1) return;
+
+        for (int ty = y0 / size; ty <= (y1 - 1) / size; ++ty) {
+            for (int tx = x0 / size; tx <= (x1 - 1) / size; ++tx) {
+                int tile = ty * columns_ + tx;
+                if (!changed_[tile]) {
+                    changed_[tile] = 1;
+                    changedList_.push_back(tile);
+                }
+            }
+        }
+    }
+
+    LayerSnapshot Layer::snapshot() {
+        const int size = Compositor::TILE_SIZE;
+        int width = canvas_.getWidth();
+        int height = canvas_.getHeight();
+
+        for (int tile : changedList_) {
+            int x = (tile % columns_) * size;
+            int y = (tile / columns_) * size;
+            int w = std::min(size, width - x);
+            int h = std::min(size, height - y);
+
+            // Bounds passed to paint() are usually generous, so a marked tile
+            // may still match what is saved; keep sharing it in that case.
+            const std::vector<uint32_t>& previous = *saved_[tile];
+            bool same = true;
+            for (int row = 0; row < h && same; ++row) {
+                same = std::memcmp(previous.data() + (size_t)row * size,
+                                   pixels_.data() + (size_t)(y + row) * width + x,
+                                   (size_t)w * sizeof(uint32_t)) == 0;
+            }
+            if (!same) {
+                auto copy = std::make_shared<std::vector<uint32_t>>((size_t)size * size, 0);
+                for (int row = 0; row < h; ++row) {
+                    std::memcpy(copy->data() + (size_t)row * size,
+                                pixels_.data() + (size_t)(y + row) * width + x,
+                                (size_t)w * sizeof(uint32_t));
+                }
+                saved_[tile] = std::move(copy);
+            }
+            changed_[tile] = 0;
+        }
+        changedList_.clear();
+
+        LayerSnapshot result;
+        result.layer_ = this;
+        result.tiles_ = saved_;
+        return result;
+    }
+
+    void Layer::restore(const LayerSnapshot& snapshot) {
+        if (snapshot.layer_ != this || snapshot.tiles_.size() != saved_.size()) return;
+        const int size = Compositor::TILE_SIZE;
+        int width = canvas_.getWidth();
+        int height = canvas_.getHeight();
+
+        for (size_t tile = 0; tile < saved_.size(); ++tile) {
+            if (!changed_[tile] && saved_[tile] == snapshot.tiles_[tile]) continue;
+            int x = ((int)tile % columns_) * size;
+            int y = ((int)tile / columns_) * size;
+            int w = std::min(size, width - x);
+            int h = std::min(size, height - y);
+            const std::vector<uint32_t>& source = *snapshot.tiles_[tile];
+            for (int row = 0; row < h; ++row) {
+                std::memcpy(pixels_.data() + (size_t)(y + row) * width + x,
+                            source.data() + (size_t)row * size,
+                            (size_t)w * sizeof(uint32_t));
+            }
+            saved_[tile] = snapshot.tiles_[tile];
+            changed_[tile] = 0;
+            owner_.invalidate(Rect(x, y, w, h));
+        }
+        changedList_.clear();
+    }
+
+    LayerHistory::LayerHistory(Layer& layer, size_t depth)
+        : layer_(layer), depth_(std::max(depth, (size_t)1)) {
+        states_.push_back(layer_.snapshot());
+    }
+
+    void LayerHistory::commit() {
+        states_.erase(states_.begin() + position_ + 1, states_.end());
+        states_.push_back(layer_.snapshot());
+        if (states_.size() > depth_ + 1) {
+            states_.pop_front();
+        }
+        position_ = states_.size() - 1;
+    }
+
+    bool LayerHistory::undo() {
+        if (!canUndo()) return false;
+        layer_.restore(states_[--position_]);
+        return true;
+    }
+
+    bool LayerHistory::redo() {
+        if (!canRedo()) return false;
+        layer_.restore(states_[++position_]);
+        return true;
+    }
+
+    Compositor::Compositor(int width, int height, uint32_t background)
+        : width_(std::max(width, 0)), height_(std::max(height, 0)), background_(background),
+          result_((size_t)width_ * height_, background | 0xFF000000),
+          columns_((width_ + TILE_SIZE - 1) / TILE_SIZE),
+          rows_((height_ + TILE_SIZE - 1) / TILE_SIZE),
+          dirty_((size_t)columns_ * rows_, 0) {}
+
+    Layer& Compositor::addLayer(const std::string& name) {
+        if (Layer* existing = getLayer(name)) return *existing;
+        layers_.emplace_back(new Layer(*this, name, width_, height_));
+        return *layers_.back();
+    }
+
+    Layer* Compositor::getLayer(const std::string& name) {
+        for (auto& layer : layers_) {
+            if (layer->name_ == name) return layer.get();
+        }
+        return nullptr;
+    }
+
+    void Compositor::removeLayer(const std::string& name) {
+        auto it = std::find_if(layers_.begin(), layers_.end(),
+            [&](const std::unique_ptr<Layer>& layer) { return layer->name_ == name; });
+        if (it == layers_.end()) return;
+        layers_.erase(it);
+        invalidateAll();
+    }
+
+    void Compositor::moveLayer(const std::string& name, int index) {
+        auto it = std::find_if(layers_.begin(), layers_.end(),
+            [&](const std::unique_ptr<Layer>& layer) { return layer->name_ == name; });
+        if (it == layers_.end()) return;
+        std::unique_ptr<Layer> layer = std::move(*it);
+        layers_.erase(it);
+        index = std::min(std::max(index, 0), (int)layers_.size());
+        layers_.insert(layers_.begin() + index, std::move(layer));
+        invalidateAll();
+    }
+
+    void Compositor::setBackground(uint32_t color) {
+        if (color == background_) return;
+        background_ = color;
+        invalidateAll();
+    }
+
+    void Compositor::invalidate(const Rect& area) {
+        int x0 = std::max(area.x, 0);
+        int y0 = std::max(area.y, 0);
+        int x1 = std::min(area.x + area.width, width_);
+        int y1 = std::min(area.y + area.height, height_);
+        if (x0 >= x1 || y0 >= y1) return;
+
+        for (int ty = y0 / TILE_SIZE; ty <= (y1 - 1) / TILE_SIZE; ++ty) {
+            for (int tx = x0 / TILE_SIZE; tx <= (x1 - 1) / TILE_SIZE; ++tx) {
+                int tile = ty * columns_ + tx;
+                if (!dirty_[tile]) {
+                    dirty_[tile] = 1;
+                    dirtyList_.push_back(tile);
+                }
+            }
+        }
+    }
+
+    void Compositor::invalidateAll() {
+        invalidate(Rect(0, 0, width_, height_));
+    }
+
+    void Compositor::blendTile(int tile) {
+        int x = (tile % columns_) * TILE_SIZE;
+        int y = (tile / columns_) * TILE_SIZE;
+        int w = std::min(TILE_SIZE, width_ - x);
+        int h = std::min(TILE_SIZE, height_ - y);
+        uint32_t background = background_ | 0xFF000000;
+
+        for (int row = y; row < y + h; ++row) {
+            uint32_t* out = result_.data() + (size_t)row * width_ + x;
+            std::fill_n(out, w, background);
+            for (const auto& layer : layers_) {
+                if (!layer->visible_ || layer->opacity_ <= 0.0f) continue;
+                uint32_t opacity = (uint32_t)(layer->opacity_ * 255.0f + 0.5f);
+                blendRow(out, layer->pixels_.data() + (size_t)row * width_ + x, w, opacity);
+            }
+        }
+    }
+
+    void Compositor::composite() {
+        if (!dirtyList_.empty()) {
+            parallelFor(0, (int)dirtyList_.size(), 1, [this](int first, int last) {
+                for (int i = first; i < last; ++i) {
+                    blendTile(dirtyList_[i]);
+                }
+            });
+            for (int tile : dirtyList_) {
+                dirty_[tile] = 0;
+            }
+            dirtyList_.clear();
+        }
+
+        if (!globalCanvas) return;
+        int width = std::min(width_, globalCanvas->getWidth());
+        int height = std::min(height_, globalCanvas->getHeight());
+        uint32_t* target = globalCanvas->getBuffer();
+        int stride = globalCanvas->getWidth();
+        const uint32_t* source = result_.data();
+        int sourceStride = width_;
+        parallelForRows(0, height, 128, [=](int y0, int y1) {
+            for (int y = y0; y < y1; ++y) {
+                std::memcpy(target + (size_t)y * stride, source + (size_t)y * sourceStride,
+                            (size_t)width * sizeof(uint32_t));
+            }
+        });
+    }
+}
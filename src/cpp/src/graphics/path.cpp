@@ -0,0 +1,250 @@
+#include "../../include/fern/graphics/path.hpp"
+#include "../../include/fern/core/canvas.hpp"
+#include "scanline.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace Fern {
+    namespace {
+        const float PI = 3.14159265358979f;
+        // Keeps subpixel coordinates within 32 bits.
+        const float COORD_LIMIT = 4.0e6f;
+
+        float length(float x, float y) {
+            return std::sqrt(x * x + y * y);
+        }
+
+        // Segments needed for a Bézier curve of the given degree whose
+        // largest second difference of control points is m: the chord of
+        // a piece 1/n long strays at most d(d-1)/8 * m / n^2 from the curve.
+        int bezierSegments(float m, int degree, float tolerance) {
+            float n = std::sqrt(degree * (degree - 1) / 8.0f * m / tolerance);
+            return std::max(1, std::min((int)std::ceil(n), 1024));
+        }
+    }
+
+    Path& Path::moveTo(float x, float y) {
+        verbs_.push_back(Verb::Move);
+        coords_.insert(coords_.end(), {x, y});
+        startX_ = currentX_ = x;
+        startY_ = currentY_ = y;
+        open_ = true;
+        return *this;
+    }
+
+    void Path::beginSubpath(float x, float y) {
+        if (open_) return;
+        // As on an HTML canvas: drawing after close() continues from the
+        // closed subpath's start; with no current point, the first point
+        // given becomes it.
+        if (!verbs_.empty() && verbs_.back() == Verb::Close) {
+            moveTo(startX_, startY_);
+        } else {
+            moveTo(x, y);
+        }
+    }
+
+    Path& Path::lineTo(float x, float y) {
+        beginSubpath(x, y);
+        verbs_.push_back(Verb::Line);
+        coords_.insert(coords_.end(), {x, y});
+        currentX_ = x;
+        currentY_ = y;
+        return *this;
+    }
+
+    Path& Path::quadTo(float cx, float cy, float x, float y) {
+        beginSubpath(cx, cy);
+        verbs_.push_back(Verb::Quad);
+        coords_.insert(coords_.end(), {cx, cy, x, y});
+        currentX_ = x;
+        currentY_ = y;
+        return *this;
+    }
+
+    Path& Path::cubicTo(float c1x, float c1y, float c2x, float c2y, float x, float y) {
+        beginSubpath(c1x, c1y);
+        verbs_.push_back(Verb::Cubic);
+        coords_.insert(coords_.end(), {c1x, c1y, c2x, c2y, x, y});
+        currentX_ = x;
+        currentY_ = y;
+        return *this;
+    }
+
+    Path& Path::arcTo(float x1, float y1, float x2, float y2, float radius) {
+        beginSubpath(x1, y1);
+
+        float ax = currentX_ - x1, ay = currentY_ - y1;
+        float bx = x2 - x1, by = y2 - y1;
+        float la = length(ax, ay), lb = length(bx, by);
+        float cross = ax * by - ay * bx;
+        if (radius <= 0.0f || la == 0.0f || lb == 0.0f || cross == 0.0f) {
+            return lineTo(x1, y1);
+        }
+        ax /= la; ay /= la;
+        bx /= lb; by /= lb;
+
+        // The circle touches both legs of the corner, tangent / tan(angle / 2)
+        // from it, with its center on the bisector.
+        float angle = std::acos(std::max(-1.0f, std::min(1.0f, ax * bx + ay * by)));
+        float tangent = radius / std::tan(angle * 0.5f);
+        float t1x = x1 + ax * tangent, t1y = y1 + ay * tangent;
+        float t2x = x1 + bx * tangent, t2y = y1 + by * tangent;
+        float mx = ax + bx, my = ay + by;
+        float ml = length(mx, my);
+        float reach = radius / std::sin(angle * 0.5f);
+        float cx = x1 + mx / ml * reach, cy = y1 + my / ml * reach;
+
+        float start = std::atan2(t1y - cy, t1x - cx);
+        float sweep = std::atan2(t2y - cy, t2x - cx) - start;
+        if (sweep > PI) sweep -= 2.0f * PI;
+        if (sweep < -PI) sweep += 2.0f * PI;
+
+        lineTo(t1x, t1y);
+        verbs_.push_back(Verb::Arc);
+        coords_.insert(coords_.end(), {cx, cy, radius, start, sweep});
+        currentX_ = t2x;
+        currentY_ = t2y;
+        return *this;
+    }
+
+    Path& Path::close() {
+        if (!open_) return *this;
+        verbs_.push_back(Verb::Close);
+        currentX_ = startX_;
+        currentY_ = startY_;
+        open_ = false;
+        return *this;
+    }
+
+    void Path::clear() {
+        verbs_.clear();
+        coords_.clear();
+        open_ = false;
+    }
+
+    void Path::setTolerance(float pixels) {
+        tolerance_ = std::max(pixels, 0.01f);
+    }
+
+    void Path::flatten(std::vector<Contour>& contours) const {
+        const float* c = coords_.data();
+        float x = 0.0f, y = 0.0f;
+        Contour* contour = nullptr;
+
+        auto add = [&](float px, float py) {
+            px = std::min(std::max(px, -COORD_LIMIT), COORD_LIMIT);
+            py = std::min(std::max(py, -COORD_LIMIT), COORD_LIMIT);
+            contour->points.push_back(px);
+            contour->points.push_back(py);
+        };
+
+        for (Verb verb : verbs_) {
+            switch (verb) {
+            case Verb::Move:
+                contours.push_back(Contour{{}, false});
+                contour = &contours.back();
+                x = c[0];
+                y = c[1];
+                add(x, y);
+                c += 2;
+                break;
+            case Verb::Line:
+                x = c[0];
+                y = c[1];
+                add(x, y);
+                c += 2;
+                break;
+            case Verb::Quad: {
+                float m = length(x - 2.0f * c[0] + c[2], y - 2.0f * c[1] + c[3]);
+                int n = bezierSegments(m, 2, tolerance_);
+                for (int i = 1; i <= n; ++i) {
+                    float t = (float)i / n, u = 1.0f - t;
+                    add(u * u * x + 2.0f * u * t * c[0] + t * t * c[2],
+                        u * u * y + 2.0f * u * t * c[1] + t * t * c[3]);
+                }
+                x = c[2];
+                y = c[3];
+                c += 4;
+                break;
+            }
+            case Verb::Cubic: {
+                float m = std::max(length(x - 2.0f * c[0] + c[2], y - 2.0f * c[1] + c[3]),
+                                   length(c[0] - 2.0f * c[2] + c[4], c[1] - 2.0f * c[3] + c[5]));
+                int n = bezierSegments(m, 3, tolerance_);
+                for (int i = 1; i <= n; ++i) {
+                    float t = (float)i / n, u = 1.0f - t;
+                    float w0 = u * u * u, w1 = 3.0f * u * u * t, w2 = 3.0f * u * t * t, w3 = t * t * t;
+                    add(w0 * x + w1 * c[0] + w2 * c[2] + w3 * c[4],
+                        w0 * y + w1 * c[1] + w2 * c[3] + w3 * c[5]);
+                }
+                x = c[4];
+                y = c[5];
+                c += 6;
+                break;
+            }
+            case Verb::Arc: {
+                // A chord spanning step radians strays r * (1 - cos(step / 2))
+                // from the circle.
+                float radius = c[2], start = c[3], sweep = c[4];
+                float ratio = 1.0f - tolerance_ / radius;
+                float step = ratio > -1.0f ? 2.0f * std::acos(ratio) : PI;
+                int n = std::max(1, std::min((int)std::ceil(std::fabs(sweep) / step), 1024));
+                for (int i = 1; i <= n; ++i) {
+                    float a = start + sweep * i / n;
+                    add(c[0] + radius * std::cos(a), c[1] + radius * std::sin(a));
+                }
+                x = contour->points[contour->points.size() - 2];
+                y = contour->points.back();
+                c += 5;
+                break;
+            }
+            case Verb::Close:
+                contour->closed = true;
+                break;
+            }
+        }
+    }
+
+    void Path::fill(uint32_t color, FillRule rule) const {
+        if (!globalCanvas || verbs_.empty()) return;
+        std::vector<Contour> contours;
+        flatten(contours);
+
+        const float scale = (float)(1 << Scanline::SUBPIXEL_SHIFT);
+        std::vector<Scanline::Edge> edges;
+        std::vector<Point> points;
+        for (const Contour& contour : contours) {
+            size_t count = contour.points.size() / 2;
+            if (count < 3) continue;
+            points.resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                points[i] = Point((int)std::lrint(contour.points[2 * i] * scale),
+                                  (int)std::lrint(contour.points[2 * i + 1] * scale));
+            }
+            Scanline::addContour(edges, points.data(), count, Scanline::SUBPIXEL_SHIFT,
+                                 globalCanvas->getHeight());
+        }
+        Scanline::fillEdges(*globalCanvas, edges, Scanline::SUBPIXEL_SHIFT, color, rule);
+    }
+
+    void Path::stroke(float width, uint32_t color, LineJoin join, LineCap cap) const {
+        if (!globalCanvas || verbs_.empty() || width <= 0.0f) return;
+        std::vector<Contour> contours;
+        flatten(contours);
+
+        // All subpaths form one region, so where they cross pixels are
+        // still written once.
+        std::vector<Scanline::Piece> pieces;
+        std::vector<Scanline::Vertex> vertices;
+        for (const Contour& contour : contours) {
+            size_t count = contour.points.size() / 2;
+            vertices.resize(count);
+            for (size_t i = 0; i < count; ++i) {
+                vertices[i] = {contour.points[2 * i], contour.points[2 * i + 1]};
+            }
+            Scanline::strokePieces(pieces, vertices, width, join, cap, contour.closed);
+        }
+        Scanline::fillPieces(*globalCanvas, pieces, color);
+    }
+}
@@ -1,50 +1,340 @@
 #include "../../include/fern/graphics/primitives.hpp"
+#include "../../include/fern/core/thread_pool.hpp"
+#include "scanline.hpp"
+#include "span.hpp"
+#include "stamp_cache.hpp"
+#include <algorithm>
 #include <cmath>
+#include <memory>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 namespace Fern {
+    namespace {
+        // Batches are split into row bands that are drawn independently.
+        const int BAND_HEIGHT = 32;
+        // Below this many instances binning costs more than it saves.
+        const size_t BATCH_PARALLEL_MIN = 64;
+
+        // Instance indices per row band, kept in submission order so each
+        // band draws overlapping instances in the same order as the caller.
+        // extent(i, top, bottom) gives the rows an instance covers and
+        // returns false when it is entirely off the canvas.
+        template <typename Extent, typename Draw>
+        void drawBinned(size_t count, Extent&& extent, Draw&& draw) {
+            int height = globalCanvas->getHeight();
+
+            if (count < BATCH_PARALLEL_MIN) {
+                for (size_t i = 0; i < count; ++i) {
+                    int top, bottom;
+                    if (extent(i, top, bottom)) draw(i, 0, height);
+                }
+                return;
+            }
+
+            int bandCount = (height + BAND_HEIGHT - 1) / BAND_HEIGHT;
+            std::vector<uint32_t> start((size_t)bandCount + 1, 0);
+            std::vector<int> firstBand(count, -1), lastBand(count, -1);
+            for (size_t i = 0; i < count; ++i) {
+                int top, bottom;
+                if (!extent(i, top, bottom)) continue;
+                top = std::max(top, 0);
+                bottom = std::min(bottom, height - 1);
+                if (top > bottom) continue;
+                firstBand[i] = top / BAND_HEIGHT;
+                lastBand[i] = bottom / BAND_HEIGHT;
+                for (int band = firstBand[i]; band <= lastBand[i]; ++band) {
+                    start[band + 1]++;
+                }
+            }
+            for (int band = 0; band < bandCount; ++band) {
+                start[band + 1] += start[band];
+            }
+            std::vector<uint32_t> items(start[bandCount]);
+            std::vector<uint32_t> next(start.begin(), start.end() - 1);
+            for (size_t i = 0; i < count; ++i) {
+                for (int band = firstBand[i]; band >= 0 && band <= lastBand[i]; ++band) {
+                    items[next[band]++] = (uint32_t)i;
+                }
+            }
+
+            parallelFor(0, bandCount, 1, [&](int first, int last) {
+                for (int band = first; band < last; ++band) {
+                    int clipTop = band * BAND_HEIGHT;
+                    int clipBottom = std::min(clipTop + BAND_HEIGHT, height);
+                    for (uint32_t k = start[band]; k < start[band + 1]; ++k) {
+                        draw(items[k], clipTop, clipBottom);
+                    }
+                }
+            });
+        }
+
+        // Triangles are walked in aligned blocks of BLOCK x BLOCK pixels.
+        const int BLOCK = 8;
+        // Edge functions of partly covered blocks are evaluated in 32 bits,
+        // which holds for vertices within this range.
+        const int COORD_LIMIT = 1 << 24;
+
+        // Triangle ready for rasterizing. Pixel (x, y) is covered when all
+        // three edge functions a * x + b * y + c are >= 0; c carries the
+        // top-left bias, so a pixel on an edge shared by two triangles goes
+        // to exactly one of them.
+        struct TriangleSetup {
+            int minX, minY, maxX, maxY;     // inclusive, on the canvas
+            int a[3], b[3];
+            int64_t c[3];
+            bool gouraud;
+            uint32_t color;
+            // Gouraud: channel values at the first vertex and their change
+            // per pixel, in B, G, R, A order.
+            float base[4], dx[4], dy[4];
+            int originX, originY;
+        };
+
+        bool setupTriangle(const Point& p0, const Point& p1, const Point& p2,
+                           uint32_t c0, uint32_t c1, uint32_t c2, bool gouraud,
+                           int width, int height, TriangleSetup& t) {
+            const Point* v[3] = {&p0, &p1, &p2};
+            uint32_t colors[3] = {c0, c1, c2};
+            for (const Point* p : v) {
+                if (std::abs(p->x) > COORD_LIMIT || std::abs(p->y) > COORD_LIMIT) return false;
+            }
+            int64_t area = (int64_t)(p1.x - p0.x) * (p2.y - p0.y) - (int64_t)(p1.y - p0.y) * (p2.x - p0.x);
+            if (area == 0) return false;
+            if (area < 0) {
+                std::swap(v[1], v[2]);
+                std::swap(colors[1], colors[2]);
+                area = -area;
+            }
+
+            t.minX = std::max(std::min({p0.x, p1.x, p2.x}), 0);
+            t.minY = std::max(std::min({p0.y, p1.y, p2.y}), 0);
+            t.maxX = std::min(std::max({p0.x, p1.x, p2.x}), width - 1);
+            t.maxY = std::min(std::max({p0.y, p1.y, p2.y}), height - 1);
+            if (t.minX > t.maxX || t.minY > t.maxY) return false;
+
+            // Edge i is opposite vertex i, so its function is that vertex's
+            // barycentric weight times the area.
+            for (int i = 0; i < 3; ++i) {
+                const Point& from = *v[(i + 1) % 3];
+                const Point& to = *v[(i + 2) % 3];
+                int ex = to.x - from.x, ey = to.y - from.y;
+                t.a[i] = -ey;
+                t.b[i] = ex;
+                t.c[i] = (int64_t)ey * from.x - (int64_t)ex * from.y;
+                // Top edges run right along the top; left edges run up.
+                bool topLeft = (ey == 0 && ex > 0) || ey < 0;
+                if (!topLeft) t.c[i] -= 1;
+            }
+
+            t.gouraud = gouraud;
+            t.color = colors[0];
+            if (gouraud) {
+                t.originX = v[0]->x;
+                t.originY = v[0]->y;
+                for (int k = 0; k < 4; ++k) {
+                    float ch[3];
+                    for (int i = 0; i < 3; ++i) ch[i] = (float)((colors[i] >> (8 * k)) & 0xFF);
+                    t.base[k] = ch[0];
+                    t.dx[k] = (t.a[0] * ch[0] + t.a[1] * ch[1] + t.a[2] * ch[2]) / (float)area;
+                    t.dy[k] = (t.b[0] * ch[0] + t.b[1] * ch[1] + t.b[2] * ch[2]) / (float)area;
+                }
+            }
+            return true;
+        }
+
+        // Writes the interpolated colors of pixels x0..x1 on one row, or of
+        // the pixels selected by mask (bit k: pixel x0 + k) when given.
+        void shadeRun(const TriangleSetup& t, uint32_t* line, int x0, int x1, int y, unsigned mask = ~0u) {
+            float fx = (float)(x0 - t.originX), fy = (float)(y - t.originY);
+#ifdef __SSE2__
+            __m128 value = _mm_add_ps(_mm_loadu_ps(t.base),
+                _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(t.dx), _mm_set1_ps(fx)),
+                           _mm_mul_ps(_mm_loadu_ps(t.dy), _mm_set1_ps(fy))));
+            __m128 step = _mm_loadu_ps(t.dx);
+            for (int x = x0; x <= x1; ++x, mask >>= 1, value = _mm_add_ps(value, step)) {
+                if (!(mask & 1)) continue;
+                __m128i channels = _mm_cvtps_epi32(value);
+                channels = _mm_packs_epi32(channels, channels);
+                line[x] = (uint32_t)_mm_cvtsi128_si32(_mm_packus_epi16(channels, channels));
+            }
+#else
+            float value[4];
+            for (int k = 0; k < 4; ++k) value[k] = t.base[k] + (t.dx[k] * fx + t.dy[k] * fy);
+            for (int x = x0; x <= x1; ++x, mask >>= 1) {
+                if (mask & 1) {
+                    uint32_t pixel = 0;
+                    for (int k = 0; k < 4; ++k) {
+                        int channel = (int)std::lrint(value[k]);
+                        pixel |= (uint32_t)std::min(std::max(channel, 0), 255) << (8 * k);
+                    }
+                    line[x] = pixel;
+                }
+                for (int k = 0; k < 4; ++k) value[k] += t.dx[k];
+            }
+#endif
+        }
+
+        // Rasterizes rows [clipTop, clipBottom) of a triangle block by block.
+        // Blocks entirely outside an edge are skipped and blocks inside all
+        // three are filled without per-pixel tests; only blocks an edge
+        // passes through test pixels, and only against those edges.
+        void rasterizeTriangle(const TriangleSetup& t, const Canvas& canvas, int clipTop, int clipBottom) {
+            int width = canvas.getWidth();
+            uint32_t* buffer = canvas.getBuffer();
+            int top = std::max(t.minY, clipTop);
+            int bottom = std::min(t.maxY, clipBottom - 1);
+
+            for (int by = top & ~(BLOCK - 1); by <= bottom; by += BLOCK) {
+                int y0 = std::max(by, top), y1 = std::min(by + BLOCK - 1, bottom);
+                for (int bx = t.minX & ~(BLOCK - 1); bx <= t.maxX; bx += BLOCK) {
+                    int x0 = std::max(bx, t.minX), x1 = std::min(bx + BLOCK - 1, t.maxX);
+
+                    int crossing[3];
+                    int crossingCount = 0;
+                    bool outside = false;
+                    for (int i = 0; i < 3 && !outside; ++i) {
+                        int64_t low = t.c[i], high = t.c[i];
+                        low += (int64_t)t.a[i] * (t.a[i] > 0 ? x0 : x1) + (int64_t)t.b[i] * (t.b[i] > 0 ? y0 : y1);
+                        high += (int64_t)t.a[i] * (t.a[i] > 0 ? x1 : x0) + (int64_t)t.b[i] * (t.b[i] > 0 ? y1 : y0);
+                        if (high < 0) outside = true;
+                        else if (low < 0) crossing[crossingCount++] = i;
+                    }
+                    if (outside) continue;
+
+                    for (int y = y0; y <= y1; ++y) {
+                        uint32_t* line = buffer + (size_t)y * width;
+                        if (crossingCount == 0) {
+                            if (t.gouraud) shadeRun(t, line, x0, x1, y);
+                            else std::fill(line + x0, line + x1 + 1, t.color);
+                            continue;
+                        }
+
+                        // Values at x0 of the crossing edges; small, since
+                        // each edge passes through this block.
+                        int32_t e[3], a[3];
+                        for (int k = 0; k < crossingCount; ++k) {
+                            int i = crossing[k];
+                            e[k] = (int32_t)(t.c[i] + (int64_t)t.a[i] * x0 + (int64_t)t.b[i] * y);
+                            a[k] = t.a[i];
+                        }
+                        for (int x = x0; x <= x1; x += 4) {
+                            int count = std::min(4, x1 - x + 1);
+                            unsigned mask;
+#ifdef __SSE2__
+                            __m128i negative = _mm_setzero_si128();
+                            for (int k = 0; k < crossingCount; ++k) {
+                                __m128i ramp = _mm_setr_epi32(0, a[k], 2 * a[k], 3 * a[k]);
+                                negative = _mm_or_si128(negative, _mm_add_epi32(_mm_set1_epi32(e[k]), ramp));
+                            }
+                            mask = ~(unsigned)_mm_movemask_ps(_mm_castsi128_ps(negative)) & ((1u << count) - 1);
+#else
+                            mask = 0;
+                            for (int j = 0; j < count; ++j) {
+                                bool inside = true;
+                                for (int k = 0; k < crossingCount; ++k) inside &= e[k] + j * a[k] >= 0;
+                                mask |= (unsigned)inside << j;
+                            }
+#endif
+                            for (int k = 0; k < crossingCount; ++k) e[k] += 4 * a[k];
+                            if (!mask) continue;
+                            if (t.gouraud) {
+                                shadeRun(t, line, x, x + count - 1, y, mask);
+                            } else {
+                                for (int j = 0; j < count; ++j) {
+                                    if (mask & (1u << j)) line[x + j] = t.color;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        // Number of instances in a batch whose per-instance arrays may also
+        // hold a single shared value.
+        size_t batchCount(size_t count, size_t valueCount) {
+            if (valueCount == 0) return 0;
+            return valueCount == 1 ? count : std::min(count, valueCount);
+        }
+    }
+
     namespace Draw {
         void fill(uint32_t color) {
             if (!globalCanvas) return;
-            for (int i = 0; i < globalCanvas->getWidth() * globalCanvas->getHeight(); ++i) {
-                globalCanvas->getBuffer()[i] = color;
-            }
+            globalCanvas->clear(color);
         }
         
         void rect(int x, int y, int width, int height, uint32_t color) {
             if (!globalCanvas) return;
+            Span::rect(*globalCanvas, 0, globalCanvas->getHeight(), x, y, width, height, color);
+        }
+        
+        void roundedRect(int x, int y, int width, int height, int radius, uint32_t color) {
+            if (!globalCanvas || width <= 0 || height <= 0) return;
+            radius = std::min(std::max(radius, 0), std::min(width, height) / 2);
+            if (radius == 0) {
+                rect(x, y, width, height, color);
+                return;
+            }
             
-            for (int dx = 0; dx < height; ++dx) {
-                for (int dy = 0; dy < width; ++dy) {
-                    int px = x + dy;
-                    int py = y + dx;
-                    if (px >= 0 && px < globalCanvas->getWidth() && 
-                        py >= 0 && py < globalCanvas->getHeight()) {
-                        globalCanvas->getBuffer()[py * globalCanvas->getWidth() + px] = color;
-                    }
-                }
+            // Each row is one span; rows level with a corner are inset by
+            // that corner's circle.
+            std::vector<int> halfWidths;
+            Span::circleHalfWidths(radius, halfWidths);
+            int canvasWidth = globalCanvas->getWidth();
+            uint32_t* buffer = globalCanvas->getBuffer();
+            int topCenter = y + radius;
+            int bottomCenter = y + height - 1 - radius;
+            int y0 = std::max(y, 0);
+            int y1 = std::min(y + height, globalCanvas->getHeight());
+            for (int row = y0; row < y1; ++row) {
+                int dy = row < topCenter ? topCenter - row : row > bottomCenter ? row - bottomCenter : 0;
+                int inset = radius - halfWidths[dy];
+                Span::fill(buffer + (size_t)row * canvasWidth, canvasWidth,
+                           x + inset, x + width - 1 - inset, color);
             }
         }
         
-        void circle(int cx, int cy, int radius, uint32_t color) {
-            if (!globalCanvas) return;
-            
-            for (int x = -radius; x <= radius; x++) {
-                for (int y = -radius; y <= radius; y++) {
-                    if (x*x + y*y <= radius*radius) {
-                        int px = cx + x;
-                        int py = cy + y;
-                        if (px >= 0 && px < globalCanvas->getWidth() && 
-                            py >= 0 && py < globalCanvas->getHeight()) {
-                            globalCanvas->getBuffer()[py * globalCanvas->getWidth() + px] = color;
-                        }
-                    }
-                }
+        void ellipse(int cx, int cy, int rx, int ry, uint32_t color) {
+            if (!globalCanvas || rx < 0 || ry < 0) return;
+            std::vector<int> halfWidths;
+            Span::ellipseHalfWidths(rx, ry, halfWidths);
+            int width = globalCanvas->getWidth();
+            uint32_t* buffer = globalCanvas->getBuffer();
+            int y0 = std::max(cy - ry, 0);
+            int y1 = std::min(cy + ry, globalCanvas->getHeight() - 1);
+            for (int row = y0; row <= y1; ++row) {
+                int w = halfWidths[std::abs(row - cy)];
+                Span::fill(buffer + (size_t)row * width, width, cx - w, cx + w, color);
             }
         }
         
+        void circle(int cx, int cy, int radius, uint32_t color) {
+            if (!globalCanvas || radius < 0) return;
+            StampCache::getInstance().get(radius, false)->draw(
+                *globalCanvas, 0, globalCanvas->getHeight(), cx, cy, color);
+        }
+        
+        void stamp(int cx, int cy, int radius, uint32_t color, bool antialiased) {
+            if (!globalCanvas || radius < 0) return;
+            StampCache::getInstance().get(radius, antialiased)->draw(
+                *globalCanvas, 0, globalCanvas->getHeight(), cx, cy, color);
+        }
+        
         void line(int x1, int y1, int x2, int y2, int thickness, uint32_t color) {
             if (!globalCanvas) return;
             
+            // Round caps and body alike are the same brush stamped along the
+            // path; look it up once.
+            std::shared_ptr<const Stamp> brush;
+            if (thickness >= 0) {
+                brush = StampCache::getInstance().get(thickness, false);
+            }
+            int height = globalCanvas->getHeight();
+            
             int dx = std::abs(x2 - x1);
             int dy = std::abs(y2 - y1);
             int sx = x1 < x2 ? 1 : -1;
@@ -52,7 +342,7 @@ namespace Fern {
             int err = dx - dy;
             
             while (true) {
-                circle(x1, y1, thickness, color);
+                if (brush) brush->draw(*globalCanvas, 0, height, x1, y1, color);
                 
                 if (x1 == x2 && y1 == y2) break;
                 
@@ -67,5 +357,113 @@ namespace Fern {
                 }
             }
         }
+
+        void polyline(const std::vector<Point>& points, int thickness, LineJoin join, LineCap cap,
+                      uint32_t color) {
+            if (!globalCanvas || points.empty() || thickness <= 0) return;
+            std::vector<Scanline::Vertex> vertices(points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                vertices[i] = {(float)points[i].x, (float)points[i].y};
+            }
+            std::vector<Scanline::Piece> pieces;
+            pieces.reserve(points.size() * 2 + 2);
+            Scanline::strokePieces(pieces, vertices, (float)thickness, join, cap, false);
+            Scanline::fillPieces(*globalCanvas, pieces, color);
+        }
+
+        void polygon(const std::vector<Point>& points, uint32_t color, FillRule rule) {
+            if (!globalCanvas || points.size() < 3) return;
+            std::vector<Scanline::Edge> edges;
+            edges.reserve(points.size());
+            Scanline::addContour(edges, points.data(), points.size(), 0, globalCanvas->getHeight());
+            Scanline::fillEdges(*globalCanvas, edges, 0, color, rule);
+        }
+
+        void circles(const std::vector<Point>& centers, const std::vector<int>& radii,
+                     const std::vector<uint32_t>& colors) {
+            if (!globalCanvas) return;
+            size_t count = batchCount(batchCount(centers.size(), radii.size()), colors.size());
+            if (count == 0) return;
+
+            // Stamps are resolved up front; the bands only replay them.
+            std::vector<std::shared_ptr<const Stamp>> stampOf(std::min(radii.size(), count));
+            for (size_t i = 0; i < stampOf.size(); ++i) {
+                if (radii[i] >= 0) {
+                    stampOf[i] = StampCache::getInstance().get(radii[i], false);
+                }
+            }
+
+            int width = globalCanvas->getWidth();
+            auto radiusOf = [&](size_t i) { return radii.size() == 1 ? radii[0] : radii[i]; };
+            drawBinned(count, [&](size_t i, int& top, int& bottom) {
+                int r = radiusOf(i);
+                const Point& c = centers[i];
+                top = c.y - r;
+                bottom = c.y + r;
+                return r >= 0 && c.x + r >= 0 && c.x - r < width;
+            }, [&](size_t i, int clipTop, int clipBottom) {
+                const Point& c = centers[i];
+                stampOf[radii.size() == 1 ? 0 : i]->draw(*globalCanvas, clipTop, clipBottom, c.x, c.y,
+                                                         colors.size() == 1 ? colors[0] : colors[i]);
+            });
+        }
+        
+        void rects(const std::vector<Rect>& rects, const std::vector<uint32_t>& colors) {
+            if (!globalCanvas) return;
+            size_t count = batchCount(rects.size(), colors.size());
+            if (count == 0) return;
+
+            int width = globalCanvas->getWidth();
+            drawBinned(count, [&](size_t i, int& top, int& bottom) {
+                const Rect& r = rects[i];
+                top = r.y;
+                bottom = r.y + r.height - 1;
+                return r.width > 0 && r.height > 0 && r.x + r.width > 0 && r.x < width;
+            }, [&](size_t i, int clipTop, int clipBottom) {
+                const Rect& r = rects[i];
+                Span::rect(*globalCanvas, clipTop, clipBottom, r.x, r.y, r.width, r.height,
+                           colors.size() == 1 ? colors[0] : colors[i]);
+            });
+        }
+
+        void triangles(const std::vector<Point>& vertices, const std::vector<int>& indices,
+                       const std::vector<uint32_t>& colors, Shading shading) {
+            if (!globalCanvas || colors.empty()) return;
+            if (colors.size() != 1 && colors.size() < vertices.size()) return;
+            size_t count = indices.size() / 3;
+            if (count == 0) return;
+
+            int width = globalCanvas->getWidth();
+            int height = globalCanvas->getHeight();
+            auto colorOf = [&](int vertex) { return colors.size() == 1 ? colors[0] : colors[vertex]; };
+            bool gouraud = shading == Shading::Gouraud && colors.size() != 1;
+
+            // Set up once; a triangle spanning several bands is visited once
+            // per band.
+            std::vector<TriangleSetup> setups(count);
+            std::vector<char> valid(count, 0);
+            parallelFor(0, (int)count, 1024, [&](int first, int last) {
+                for (int i = first; i < last; ++i) {
+                    const int* index = indices.data() + 3 * (size_t)i;
+                    bool inRange = true;
+                    for (int k = 0; k < 3; ++k) {
+                        inRange &= index[k] >= 0 && (size_t)index[k] < vertices.size();
+                    }
+                    if (!inRange) continue;
+                    valid[i] = setupTriangle(vertices[index[0]], vertices[index[1]], vertices[index[2]],
+                                             colorOf(index[0]), colorOf(index[1]), colorOf(index[2]),
+                                             gouraud, width, height, setups[i]);
+                }
+            });
+
+            drawBinned(count, [&](size_t i, int& top, int& bottom) {
+                if (!valid[i]) return false;
+                top = setups[i].minY;
+                bottom = setups[i].maxY;
+                return true;
+            }, [&](size_t i, int clipTop, int clipBottom) {
+                rasterizeTriangle(setups[i], *globalCanvas, clipTop, clipBottom);
+            });
+        }
     }
-}
\ No newline at end of file
+}
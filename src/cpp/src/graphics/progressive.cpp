@@ -0,0 +1,60 @@
+#include "../../include/fern/graphics/progressive.hpp"
+#include <algorithm>
+
+namespace Fern {
+    namespace {
+        Rect clipToCanvas(const Rect& area) {
+            int x0 = std::max(area.x, 0);
+            int y0 = std::max(area.y, 0);
+            int x1 = std::min(area.x + area.width, globalCanvas->getWidth());
+            int y1 = std::min(area.y + area.height, globalCanvas->getHeight());
+            return Rect(x0, y0, std::max(x1 - x0, 0), std::max(y1 - y0, 0));
+        }
+    }
+
+    constexpr int ProgressiveRenderer::BAND_HEIGHT;
+
+    ProgressiveRenderer::ProgressiveRenderer(int coarseBlockSize, double budgetMs)
+        : coarseBlockSize_(1), budgetMs_(budgetMs) {
+        while (coarseBlockSize_ < coarseBlockSize) {
+            coarseBlockSize_ *= 2;
+        }
+    }
+
+    void ProgressiveRenderer::invalidate() {
+        blockSize_ = coarseBlockSize_;
+        nextRow_ = 0;
+    }
+
+    bool ProgressiveRenderer::begin(const Rect& area) {
+        if (!globalCanvas) return false;
+
+        Rect clipped = clipToCanvas(area);
+        if (clipped.width <= 0 || clipped.height <= 0) return false;
+
+        if (clipped.x != area_.x || clipped.y != area_.y ||
+            clipped.width != area_.width || clipped.height != area_.height) {
+            area_ = clipped;
+            image_.assign((size_t)clipped.width * clipped.height, 0);
+            invalidate();
+        }
+        return true;
+    }
+
+    void ProgressiveRenderer::advance(int bandHeight) {
+        nextRow_ += bandHeight;
+        if (nextRow_ >= area_.height) {
+            nextRow_ = 0;
+            blockSize_ /= 2;
+        }
+    }
+
+    void ProgressiveRenderer::present() const {
+        uint32_t* buffer = globalCanvas->getBuffer();
+        int stride = globalCanvas->getWidth();
+        for (int y = 0; y < area_.height; ++y) {
+            std::copy_n(image_.data() + (size_t)y * area_.width, area_.width,
+                        buffer + (size_t)(area_.y + y) * stride + area_.x);
+        }
+    }
+}
@@ -0,0 +1,318 @@
+#include "scanline.hpp"
+#include "span.hpp"
+#include "../../include/fern/core/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace Fern {
+    namespace Scanline {
+        namespace {
+            // Rows are filled in bands like the batch primitives; large
+            // outlines draw their bands in parallel.
+            const int BAND_HEIGHT = 32;
+            const size_t PARALLEL_MIN = 64;
+
+            int64_t floorDiv(int64_t a, int64_t b) {
+                return a / b - (a % b != 0 && (a < 0) != (b < 0));
+            }
+
+            void addPolygon(std::vector<Piece>& pieces, std::initializer_list<float> coords) {
+                Piece piece;
+                piece.corners = (int)coords.size() / 2;
+                const float* c = coords.begin();
+                piece.top = piece.bottom = c[1];
+                for (int i = 0; i < piece.corners; ++i) {
+                    piece.x[i] = c[2 * i];
+                    piece.y[i] = c[2 * i + 1];
+                    piece.top = std::min(piece.top, piece.y[i]);
+                    piece.bottom = std::max(piece.bottom, piece.y[i]);
+                }
+                pieces.push_back(piece);
+            }
+
+            void addDisc(std::vector<Piece>& pieces, float cx, float cy, float radius) {
+                Piece piece;
+                piece.corners = 0;
+                piece.cx = cx;
+                piece.cy = cy;
+                piece.radius = radius;
+                piece.top = cy - radius;
+                piece.bottom = cy + radius;
+                pieces.push_back(piece);
+            }
+
+            // Where the row through y crosses the piece, if it does.
+            bool pieceSpan(const Piece& piece, float y, float& left, float& right) {
+                if (piece.corners == 0) {
+                    float dy = y - piece.cy;
+                    float squared = piece.radius * piece.radius - dy * dy;
+                    if (squared <= 0.0f) return false;
+                    float half = std::sqrt(squared);
+                    left = piece.cx - half;
+                    right = piece.cx + half;
+                    return true;
+                }
+                bool found = false;
+                for (int i = 0; i < piece.corners; ++i) {
+                    int j = i + 1 == piece.corners ? 0 : i + 1;
+                    float y0 = piece.y[i], y1 = piece.y[j];
+                    if ((y0 <= y) == (y1 <= y)) continue;
+                    float x = piece.x[i] + (y - y0) * (piece.x[j] - piece.x[i]) / (y1 - y0);
+                    left = found ? std::min(left, x) : x;
+                    right = found ? std::max(right, x) : x;
+                    found = true;
+                }
+                return found;
+            }
+
+            // Fills the wedge between the segments meeting at (x, y), coming
+            // in along (ax, ay) and leaving along (bx, by), both unit length.
+            // Only the outside of the turn needs it; the segments cover the
+            // inside.
+            void addJoin(std::vector<Piece>& pieces, float x, float y, float ax, float ay,
+                         float bx, float by, float half, LineJoin join) {
+                if (join == LineJoin::Round) {
+                    addDisc(pieces, x, y, half);
+                    return;
+                }
+                float cross = ax * by - ay * bx;
+                if (cross == 0.0f) return;
+
+                float side = cross > 0.0f ? -1.0f : 1.0f;
+                float ox0 = -ay * half * side, oy0 = ax * half * side;
+                float ox1 = -by * half * side, oy1 = bx * half * side;
+
+                if (join == LineJoin::Miter) {
+                    // The tip lies along the bisector of the two outer normals,
+                    // half / cos(angle / 2) from the vertex.
+                    float mx = ox0 + ox1, my = oy0 + oy1;
+                    float m = std::sqrt(mx * mx + my * my);
+                    float cosine = m / (2.0f * half);
+                    if (cosine >= 0.25f) {
+                        float reach = half / cosine;
+                        addPolygon(pieces, {x, y, x + ox0, y + oy0,
+                                            x + mx / m * reach, y + my / m * reach, x + ox1, y + oy1});
+                        return;
+                    }
+                }
+                addPolygon(pieces, {x, y, x + ox0, y + oy0, x + ox1, y + oy1});
+            }
+        }
+
+        void addContour(std::vector<Edge>& edges, const Point* points, size_t count,
+                        int shift, int height) {
+            const int64_t unit = (int64_t)1 << shift;
+            for (size_t i = 0; i < count; ++i) {
+                const Point& a = points[i];
+                const Point& b = points[i + 1 == count ? 0 : i + 1];
+                if (a.y == b.y) continue;
+                const Point& upper = a.y < b.y ? a : b;
+                const Point& lower = a.y < b.y ? b : a;
+
+                // Rows whose centers fall in [upper.y, lower.y).
+                int top = (int)floorDiv(upper.y + unit - 1, unit);
+                int bottom = (int)floorDiv(lower.y + unit - 1, unit);
+                top = std::max(top, 0);
+                bottom = std::min(bottom, height);
+                if (top >= bottom) continue;
+
+                Edge edge;
+                int64_t dx = lower.x - upper.x;
+                edge.dy = lower.y - upper.y;
+                edge.step = floorDiv(dx * unit, edge.dy);
+                edge.remainder = dx * unit - edge.step * edge.dy;
+                edge.top = top;
+                edge.bottom = bottom;
+                int64_t offset = dx * (top * unit - upper.y);
+                int64_t whole = floorDiv(offset, edge.dy);
+                edge.x = upper.x + whole;
+                edge.fraction = offset - whole * edge.dy;
+                edge.winding = a.y < b.y ? 1 : -1;
+                edges.push_back(edge);
+            }
+        }
+
+        void fillEdges(const Canvas& canvas, std::vector<Edge>& edges, int shift,
+                       uint32_t color, FillRule rule) {
+            if (edges.empty()) return;
+            int width = canvas.getWidth();
+            uint32_t* buffer = canvas.getBuffer();
+            const int64_t round = ((int64_t)1 << shift) - 1;
+            std::sort(edges.begin(), edges.end(),
+                      [](const Edge& a, const Edge& b) { return a.top < b.top; });
+
+            // Pixels whose centers lie in [left, right) are inside: the
+            // first is the crossing rounded up to a whole pixel.
+            auto firstPixel = [&](const Edge& edge) {
+                return (int)((edge.x + (edge.fraction > 0) + round) >> shift);
+            };
+
+            std::vector<Edge> active;
+            size_t next = 0;
+            int row = edges[0].top;
+            while (next < edges.size() || !active.empty()) {
+                if (active.empty()) row = std::max(row, edges[next].top);
+                while (next < edges.size() && edges[next].top == row) {
+                    active.push_back(edges[next++]);
+                }
+
+                // Crossings move little from row to row, so the list stays
+                // nearly sorted and insertion sort is close to linear.
+                for (size_t i = 1; i < active.size(); ++i) {
+                    Edge edge = active[i];
+                    size_t j = i;
+                    for (; j > 0 && edge < active[j - 1]; --j) {
+                        active[j] = active[j - 1];
+                    }
+                    active[j] = edge;
+                }
+
+                uint32_t* line = buffer + (size_t)row * width;
+                int winding = 0;
+                for (size_t i = 0; i + 1 < active.size(); ++i) {
+                    winding += rule == FillRule::EvenOdd ? 1 : active[i].winding;
+                    bool inside = rule == FillRule::EvenOdd ? (winding & 1) != 0 : winding != 0;
+                    if (!inside) continue;
+                    Span::fill(line, width, firstPixel(active[i]), firstPixel(active[i + 1]) - 1, color);
+                }
+
+                ++row;
+                size_t kept = 0;
+                for (size_t i = 0; i < active.size(); ++i) {
+                    Edge& edge = active[i];
+                    if (edge.bottom <= row) continue;
+                    edge.x += edge.step;
+                    edge.fraction += edge.remainder;
+                    if (edge.fraction >= edge.dy) {
+                        edge.fraction -= edge.dy;
+                        edge.x++;
+                    }
+                    active[kept++] = edge;
+                }
+                active.resize(kept);
+            }
+        }
+
+        void strokePieces(std::vector<Piece>& pieces, const std::vector<Vertex>& input,
+                          float width, LineJoin join, LineCap cap, bool closed) {
+            if (input.empty() || width <= 0.0f) return;
+
+            // Repeated points carry no direction.
+            std::vector<Vertex> points;
+            points.reserve(input.size());
+            for (const Vertex& v : input) {
+                if (points.empty() || v.x != points.back().x || v.y != points.back().y) {
+                    points.push_back({v.x + 0.5f, v.y + 0.5f});
+                }
+            }
+            if (closed && points.size() > 1 &&
+                points.back().x == points.front().x && points.back().y == points.front().y) {
+                points.pop_back();
+            }
+
+            float half = width * 0.5f;
+            if (points.size() == 1) {
+                float x = points[0].x, y = points[0].y;
+                if (cap == LineCap::Round) {
+                    addDisc(pieces, x, y, half);
+                } else if (cap == LineCap::Square) {
+                    addPolygon(pieces, {x - half, y - half, x + half, y - half,
+                                        x + half, y + half, x - half, y + half});
+                }
+                return;
+            }
+
+            size_t count = points.size();
+            size_t segments = closed ? count : count - 1;
+            std::vector<Vertex> directions(segments);
+            for (size_t i = 0; i < segments; ++i) {
+                Vertex p0 = points[i];
+                Vertex p1 = points[i + 1 == count ? 0 : i + 1];
+                float length = std::sqrt((p1.x - p0.x) * (p1.x - p0.x) + (p1.y - p0.y) * (p1.y - p0.y));
+                float dx = (p1.x - p0.x) / length, dy = (p1.y - p0.y) / length;
+                directions[i] = {dx, dy};
+                if (!closed && cap == LineCap::Square) {
+                    if (i == 0) { p0.x -= dx * half; p0.y -= dy * half; }
+                    if (i + 1 == segments) { p1.x += dx * half; p1.y += dy * half; }
+                }
+                float nx = -dy * half, ny = dx * half;
+                addPolygon(pieces, {p0.x + nx, p0.y + ny, p1.x + nx, p1.y + ny,
+                                    p1.x - nx, p1.y - ny, p0.x - nx, p0.y - ny});
+            }
+
+            if (!closed && cap == LineCap::Round) {
+                addDisc(pieces, points[0].x, points[0].y, half);
+                addDisc(pieces, points[count - 1].x, points[count - 1].y, half);
+            }
+
+            for (size_t i = closed ? 0 : 1; i < (closed ? count : count - 1); ++i) {
+                const Vertex& in = directions[i == 0 ? segments - 1 : i - 1];
+                const Vertex& out = directions[i];
+                addJoin(pieces, points[i].x, points[i].y, in.x, in.y, out.x, out.y, half, join);
+            }
+        }
+
+        void fillPieces(const Canvas& canvas, std::vector<Piece>& pieces, uint32_t color) {
+            int width = canvas.getWidth();
+            int height = canvas.getHeight();
+            if (pieces.empty()) return;
+
+            std::sort(pieces.begin(), pieces.end(),
+                      [](const Piece& a, const Piece& b) { return a.top < b.top; });
+            float bottom = pieces[0].bottom;
+            for (const Piece& piece : pieces) bottom = std::max(bottom, piece.bottom);
+            int firstRow = std::max((int)std::floor(pieces[0].top), 0);
+            int lastRow = std::min((int)std::ceil(bottom), height - 1);
+            if (firstRow > lastRow) return;
+
+            int bandCount = (lastRow - firstRow) / BAND_HEIGHT + 1;
+            auto drawBands = [&](int firstBand, int lastBand) {
+                std::vector<const Piece*> active;
+                std::vector<std::pair<int, int>> spans;
+                for (int band = firstBand; band < lastBand; ++band) {
+                    int y0 = firstRow + band * BAND_HEIGHT;
+                    int y1 = std::min(y0 + BAND_HEIGHT, lastRow + 1);
+
+                    active.clear();
+                    for (const Piece& piece : pieces) {
+                        if (piece.top > y1) break;
+                        if (piece.bottom >= y0) active.push_back(&piece);
+                    }
+
+                    for (int row = y0; row < y1; ++row) {
+                        float center = row + 0.5f;
+                        spans.clear();
+                        for (const Piece* piece : active) {
+                            float left, right;
+                            if (!pieceSpan(*piece, center, left, right)) continue;
+                            // Pixels whose centers fall inside [left, right).
+                            int x0 = (int)std::ceil(left - 0.5f);
+                            int x1 = (int)std::ceil(right - 0.5f) - 1;
+                            if (x0 <= x1) spans.emplace_back(x0, x1);
+                        }
+                        if (spans.empty()) continue;
+
+                        std::sort(spans.begin(), spans.end());
+                        uint32_t* line = canvas.getBuffer() + (size_t)row * width;
+                        int runStart = spans[0].first, runEnd = spans[0].second;
+                        for (size_t i = 1; i < spans.size(); ++i) {
+                            if (spans[i].first > runEnd + 1) {
+                                Span::fill(line, width, runStart, runEnd, color);
+                                runStart = spans[i].first;
+                            }
+                            runEnd = std::max(runEnd, spans[i].second);
+                        }
+                        Span::fill(line, width, runStart, runEnd, color);
+                    }
+                }
+            };
+
+            if (pieces.size() < PARALLEL_MIN) {
+                drawBands(0, bandCount);
+            } else {
+                parallelFor(0, bandCount, 1, [&](int first, int last) { drawBands(first, last); });
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "../../include/fern/core/canvas.hpp"
+#include "../../include/fern/core/types.hpp"
+#include "../../include/fern/graphics/primitives.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Fern {
+    // Scanline filling shared by Draw::polygon, Draw::polyline and Path.
+    // Vertex (x, y) sits on the center of pixel (x, y) throughout.
+    namespace Scanline {
+        // Path coordinates are filled in 1/256 pixel steps.
+        const int SUBPIXEL_SHIFT = 8;
+
+        struct Vertex {
+            float x;
+            float y;
+        };
+
+        // Polygon edge covering rows [top, bottom). Its crossing is
+        // x + fraction / dy in units of 1 / 2^shift pixels, stepped with
+        // integers like a Bresenham line so it never drifts.
+        struct Edge {
+            int top;
+            int bottom;
+            int64_t x;
+            int64_t fraction;       // [0, dy)
+            int64_t step;
+            int64_t remainder;      // [0, dy)
+            int64_t dy;
+            int winding;
+
+            bool operator<(const Edge& other) const {
+                if (x != other.x) return x < other.x;
+                return fraction * other.dy < other.fraction * dy;
+            }
+        };
+
+        // Adds the closed outline through points, given in units of
+        // 1 / 2^shift pixels. Edges outside rows [0, height) are dropped.
+        void addContour(std::vector<Edge>& edges, const Point* points, size_t count,
+                        int shift, int height);
+
+        // Fills the area enclosed by edges under rule, each pixel once.
+        void fillEdges(const Canvas& canvas, std::vector<Edge>& edges, int shift,
+                       uint32_t color, FillRule rule);
+
+        // Convex part of a stroked outline: a polygon of up to four corners,
+        // or a disc. Coordinates have pixel (x, y) centered on
+        // (x + 0.5, y + 0.5).
+        struct Piece {
+            float top, bottom;
+            int corners;            // 0 for a disc
+            float x[4], y[4];
+            float cx, cy, radius;
+        };
+
+        // Adds the pieces of a polyline stroked width pixels wide. Closed
+        // outlines join their last point back to the first and get no caps.
+        void strokePieces(std::vector<Piece>& pieces, const std::vector<Vertex>& points,
+                          float width, LineJoin join, LineCap cap, bool closed);
+
+        // Fills the union of the pieces: per row, the pieces' spans are
+        // merged before anything is written.
+        void fillPieces(const Canvas& canvas, std::vector<Piece>& pieces, uint32_t color);
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../../include/fern/core/canvas.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace Fern {
+    // Horizontal span filling shared by the shape rasterizers. Shapes are
+    // drawn as runs of one color per row, clipped once per run instead of
+    // once per pixel.
+    namespace Span {
+        // Fills [x0, x1] (inclusive) on one row, clipped to [0, width).
+        inline void fill(uint32_t* row, int width, int x0, int x1, uint32_t color) {
+            x0 = std::max(x0, 0);
+            x1 = std::min(x1, width - 1);
+            if (x0 <= x1) {
+                std::fill(row + x0, row + x1 + 1, color);
+            }
+        }
+
+        // halfWidths[|dy|] for dy in [0, ry]: the pixels of row cy + dy
+        // covered by a filled ellipse are cx - w .. cx + w, those whose
+        // centers pass ry^2 x^2 + rx^2 y^2 <= rx^2 ry^2.
+        //
+        // Midpoint-style recurrence: w only shrinks as dy grows, and both
+        // sides of the test are updated by adding the next odd multiple
+        // instead of being squared again.
+        inline void ellipseHalfWidths(int rx, int ry, std::vector<int>& halfWidths) {
+            rx = std::max(rx, 0);
+            ry = std::max(ry, 0);
+            halfWidths.resize(ry + 1);
+            int64_t rx2 = (int64_t)rx * rx, ry2 = (int64_t)ry * ry;
+            int64_t limit = rx2 * ry2;
+            int64_t across = ry2 * rx2;     // ry^2 w^2 for w = rx
+            int64_t down = 0;               // rx^2 dy^2
+            int w = rx;
+            for (int dy = 0; dy <= ry; ++dy) {
+                while (w > 0 && across + down > limit) {
+                    across -= ry2 * (2 * w - 1);
+                    --w;
+                }
+                halfWidths[dy] = w;
+                down += rx2 * (2 * dy + 1);
+            }
+        }
+
+        // The circle case, matching the x*x + y*y <= radius*radius test of
+        // Draw::circle.
+        inline void circleHalfWidths(int radius, std::vector<int>& halfWidths) {
+            ellipseHalfWidths(radius, radius, halfWidths);
+        }
+
+        // Filled rectangle limited to rows [clipTop, clipBottom).
+        inline void rect(const Canvas& canvas, int clipTop, int clipBottom,
+                         int x, int y, int w, int h, uint32_t color) {
+            if (w <= 0 || h <= 0) return;
+            int width = canvas.getWidth();
+            uint32_t* buffer = canvas.getBuffer();
+            int y0 = std::max(y, clipTop);
+            int y1 = std::min(y + h, clipBottom);
+            for (int row = y0; row < y1; ++row) {
+                fill(buffer + (size_t)row * width, width, x, x + w - 1, color);
+            }
+        }
+    }
+}
@@ -0,0 +1,135 @@
+#include "stamp_cache.hpp"
+#include "span.hpp"
+#include "../../include/fern/graphics/colors.hpp"
+#include <algorithm>
+
+namespace Fern {
+    namespace {
+        // Antialiased coverage is sampled on a 4x4 grid per pixel.
+        const int SAMPLES = 4;
+    }
+
+    void Stamp::draw(const Canvas& canvas, int clipTop, int clipBottom,
+                     int cx, int cy, uint32_t color) const {
+        int width = canvas.getWidth();
+        uint32_t* buffer = canvas.getBuffer();
+        int y0 = std::max(cy - radius, clipTop);
+        int y1 = std::min(cy + radius + 1, clipBottom);
+        int size = 2 * radius + 1;
+
+        for (int y = y0; y < y1; ++y) {
+            int dy = y - cy;
+            const Row& row = rows[dy + radius];
+            uint32_t* line = buffer + (size_t)y * width;
+            Span::fill(line, width, cx + row.solidFirst, cx + row.solidLast, color);
+            if (!antialiased) continue;
+
+            // Partially covered pixels on both ends of the row.
+            const uint8_t* mask = coverage.data() + (size_t)(dy + radius) * size + radius;
+            int left = std::max(row.first, -cx);
+            int leftEnd = std::min(row.solidFirst - 1, width - 1 - cx);
+            for (int dx = left; dx <= leftEnd; ++dx) {
+                line[cx + dx] = Colors::blendAlpha(line[cx + dx], color, mask[dx]);
+            }
+            int right = std::max(std::max(row.solidLast + 1, row.first), -cx);
+            int rightEnd = std::min(row.last, width - 1 - cx);
+            for (int dx = right; dx <= rightEnd; ++dx) {
+                line[cx + dx] = Colors::blendAlpha(line[cx + dx], color, mask[dx]);
+            }
+        }
+    }
+
+    StampCache& StampCache::getInstance() {
+        static StampCache instance;
+        return instance;
+    }
+
+    std::shared_ptr<const Stamp> StampCache::build(int radius, bool antialiased) {
+        auto stamp = std::make_shared<Stamp>();
+        stamp->radius = radius;
+        stamp->antialiased = antialiased;
+        int size = 2 * radius + 1;
+        stamp->rows.resize(size);
+
+        if (!antialiased) {
+            std::vector<int> halfWidths;
+            Span::circleHalfWidths(radius, halfWidths);
+            for (int dy = -radius; dy <= radius; ++dy) {
+                int w = halfWidths[std::abs(dy)];
+                stamp->rows[dy + radius] = {-w, w, -w, w};
+            }
+            return stamp;
+        }
+
+        // Disc of radius + 0.5 around the center pixel's center, so the hard
+        // and antialiased stamps of one radius have the same extent.
+        float edge = radius + 0.5f;
+        float edgeSquared = edge * edge;
+        stamp->coverage.assign((size_t)size * size, 0);
+        for (int dy = -radius; dy <= radius; ++dy) {
+            Stamp::Row row = {1, 0, 1, 0};
+            bool any = false;
+            uint8_t* mask = stamp->coverage.data() + (size_t)(dy + radius) * size + radius;
+            for (int dx = -radius; dx <= radius; ++dx) {
+                int inside = 0;
+                for (int sy = 0; sy < SAMPLES; ++sy) {
+                    float py = dy - 0.5f + (sy + 0.5f) / SAMPLES;
+                    for (int sx = 0; sx < SAMPLES; ++sx) {
+                        float px = dx - 0.5f + (sx + 0.5f) / SAMPLES;
+                        inside += px * px + py * py <= edgeSquared;
+                    }
+                }
+                uint8_t value = (uint8_t)((inside * 255 + SAMPLES * SAMPLES / 2) / (SAMPLES * SAMPLES));
+                mask[dx] = value;
+                if (value == 0) continue;
+                if (!any) row.first = dx;
+                row.last = dx;
+                any = true;
+            }
+            // Fully covered pixels form one run around the center.
+            if (any && mask[0] == 255) {
+                int solid = 0;
+                while (solid < radius && mask[solid + 1] == 255) ++solid;
+                row.solidFirst = -solid;
+                row.solidLast = solid;
+            }
+            stamp->rows[dy + radius] = row;
+        }
+        return stamp;
+    }
+
+    std::shared_ptr<const Stamp> StampCache::get(int radius, bool antialiased) {
+        uint64_t key = ((uint64_t)(uint32_t)radius << 1) | (antialiased ? 1 : 0);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto found = index_.find(key);
+            if (found != index_.end()) {
+                entries_.splice(entries_.begin(), entries_, found->second);
+                return found->second->second;
+            }
+        }
+
+        // Built without the lock, so other threads keep drawing cached
+        // stamps meanwhile. Two threads missing on the same key both build
+        // it; the first one stored wins.
+        std::shared_ptr<const Stamp> stamp = build(radius, antialiased);
+        size_t bytes = stamp->bytes();
+        if (bytes > MAX_BYTES) return stamp;
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto found = index_.find(key);
+        if (found != index_.end()) {
+            entries_.splice(entries_.begin(), entries_, found->second);
+            return found->second->second;
+        }
+        while (bytes_ + bytes > MAX_BYTES && !entries_.empty()) {
+            bytes_ -= entries_.back().second->bytes();
+            index_.erase(entries_.back().first);
+            entries_.pop_back();
+        }
+        entries_.emplace_front(key, stamp);
+        index_[key] = entries_.begin();
+        bytes_ += bytes;
+        return stamp;
+    }
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "../../include/fern/core/canvas.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Fern {
+    // Rasterized round brush of one radius, ready to be replayed as spans.
+    struct Stamp {
+        // Pixels covered on row dy (-radius .. radius) are first .. last,
+        // relative to the center; solidFirst .. solidLast of them are fully
+        // covered. Hard stamps are solid across the whole row.
+        struct Row {
+            int first;
+            int last;
+            int solidFirst;
+            int solidLast;
+        };
+
+        int radius = 0;
+        bool antialiased = false;
+        std::vector<Row> rows;
+        // Antialiased stamps: (2 * radius + 1)^2 coverage values, row-major.
+        std::vector<uint8_t> coverage;
+
+        size_t bytes() const { return sizeof(Stamp) + rows.size() * sizeof(Row) + coverage.size(); }
+
+        // Draws the stamp centered on (cx, cy), limited to canvas rows
+        // [clipTop, clipBottom).
+        void draw(const Canvas& canvas, int clipTop, int clipBottom,
+                  int cx, int cy, uint32_t color) const;
+    };
+
+    // Least-recently-used cache of stamps, bounded by memory. Handles stay
+    // valid after eviction, so a batch can hold several at once. get() may
+    // be called from any thread; stamps are immutable once built.
+    class StampCache {
+    public:
+        static StampCache& getInstance();
+
+        std::shared_ptr<const Stamp> get(int radius, bool antialiased);
+
+    private:
+        static constexpr size_t MAX_BYTES = 4 * 1024 * 1024;
+
+        StampCache() = default;
+        static std::shared_ptr<const Stamp> build(int radius, bool antialiased);
+
+        using Entry = std::pair<uint64_t, std::shared_ptr<const Stamp>>;
+        std::mutex mutex_;              // guards everything below
+        std::list<Entry> entries_;      // most recently used first
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+        size_t bytes_ = 0;
+    };
+}
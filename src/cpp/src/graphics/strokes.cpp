@@ -0,0 +1,220 @@
+#include "../../include/fern/graphics/strokes.hpp"
+#include "../../include/fern/graphics/primitives.hpp"
+#include "../../include/fern/core/canvas.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace Fern {
+    namespace {
+        // Deltas are zigzag encoded so small negative steps stay small, then
+        // written seven bits per byte.
+        void writeDelta(std::vector<uint8_t>& out, int delta) {
+            uint32_t value = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+            while (value >= 0x80) {
+                out.push_back((uint8_t)(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back((uint8_t)value);
+        }
+
+        int readDelta(const uint8_t*& in) {
+            uint32_t value = 0;
+            int shift = 0;
+            uint8_t byte;
+            do {
+                byte = *in++;
+                value |= (uint32_t)(byte & 0x7F) << shift;
+                shift += 7;
+            } while (byte & 0x80);
+            return (int)(value >> 1) ^ -(int)(value & 1);
+        }
+
+        float distanceSquared(const Point& p, const Point& a, const Point& b) {
+            float abx = (float)(b.x - a.x), aby = (float)(b.y - a.y);
+            float apx = (float)(p.x - a.x), apy = (float)(p.y - a.y);
+            float length = abx * abx + aby * aby;
+            float t = length > 0.0f ? std::min(std::max((apx * abx + apy * aby) / length, 0.0f), 1.0f) : 0.0f;
+            float dx = apx - t * abx, dy = apy - t * aby;
+            return dx * dx + dy * dy;
+        }
+
+        bool overlaps(const Rect& a, const Rect& b) {
+            return a.x < b.x + b.width && b.x < a.x + a.width &&
+                   a.y < b.y + b.height && b.y < a.y + a.height;
+        }
+    }
+
+    StrokeRecorder::StrokeRecorder(float tolerance) : tolerance_(std::max(tolerance, 0.0f)) {}
+
+    void StrokeRecorder::begin(int x, int y, int size, uint32_t color) {
+        if (recording_) end();
+
+        Stroke stroke;
+        stroke.color = color;
+        stroke.size = std::max(size, 0);
+        stroke.first = Point(x, y);
+        stroke.offset = (uint32_t)data_.size();
+        stroke.pointCount = 1;
+        strokes_.push_back(stroke);
+
+        recording_ = true;
+        last_ = stroke.first;
+        pending_.assign(1, stroke.first);
+        minX_ = maxX_ = x;
+        minY_ = maxY_ = y;
+        updateBounds(stroke.first);
+    }
+
+    void StrokeRecorder::addPoint(int x, int y) {
+        if (!recording_) return;
+        Point point(x, y);
+        const Point& previous = pending_.back();
+        if (point.x == previous.x && point.y == previous.y) return;
+
+        pending_.push_back(point);
+        updateBounds(point);
+        if (pending_.size() >= WINDOW) flush();
+    }
+
+    void StrokeRecorder::end() {
+        if (!recording_) return;
+        flush();
+        recording_ = false;
+        pending_.clear();
+    }
+
+    void StrokeRecorder::updateBounds(const Point& point) {
+        minX_ = std::min(minX_, point.x);
+        minY_ = std::min(minY_, point.y);
+        maxX_ = std::max(maxX_, point.x);
+        maxY_ = std::max(maxY_, point.y);
+        Stroke& stroke = strokes_.back();
+        stroke.bounds = Rect(minX_ - stroke.size, minY_ - stroke.size,
+                             maxX_ - minX_ + 2 * stroke.size + 1,
+                             maxY_ - minY_ + 2 * stroke.size + 1);
+    }
+
+    void StrokeRecorder::emit(const Point& point) {
+        Stroke& stroke = strokes_.back();
+        writeDelta(data_, point.x - last_.x);
+        writeDelta(data_, point.y - last_.y);
+        stroke.pointCount++;
+        last_ = point;
+    }
+
+    void StrokeRecorder::flush() {
+        size_t count = pending_.size();
+        if (count < 2) return;
+
+        // Douglas-Peucker over the window. Its first point is already stored
+        // and its last one is always kept, so windows join up exactly.
+        std::vector<char> keep(count, 0);
+        keep[count - 1] = 1;
+        float limit = tolerance_ * tolerance_;
+        std::vector<std::pair<size_t, size_t>> ranges(1, std::make_pair((size_t)0, count - 1));
+        while (!ranges.empty()) {
+            size_t first = ranges.back().first;
+            size_t last = ranges.back().second;
+            ranges.pop_back();
+
+            float farthest = limit;
+            size_t split = 0;
+            for (size_t i = first + 1; i < last; ++i) {
+                float distance = distanceSquared(pending_[i], pending_[first], pending_[last]);
+                if (distance > farthest) {
+                    farthest = distance;
+                    split = i;
+                }
+            }
+            if (split == 0) continue;
+            keep[split] = 1;
+            ranges.push_back(std::make_pair(first, split));
+            ranges.push_back(std::make_pair(split, last));
+        }
+
+        for (size_t i = 1; i < count; ++i) {
+            if (keep[i]) emit(pending_[i]);
+        }
+        pending_.assign(1, pending_.back());
+    }
+
+    void StrokeRecorder::removeLast() {
+        if (strokes_.empty()) return;
+        if (recording_) {
+            recording_ = false;
+            pending_.clear();
+        }
+        data_.resize(strokes_.back().offset);
+        strokes_.pop_back();
+    }
+
+    void StrokeRecorder::clear() {
+        recording_ = false;
+        pending_.clear();
+        strokes_.clear();
+        data_.clear();
+    }
+
+    void StrokeRecorder::getPoints(size_t index, std::vector<Point>& out) const {
+        const Stroke& stroke = strokes_[index];
+        out.clear();
+        out.reserve(stroke.pointCount + pending_.size());
+        Point point = stroke.first;
+        out.push_back(point);
+        const uint8_t* in = data_.data() + stroke.offset;
+        for (uint32_t i = 1; i < stroke.pointCount; ++i) {
+            point.x += readDelta(in);
+            point.y += readDelta(in);
+            out.push_back(point);
+        }
+
+        // Input of the stroke being recorded that is not simplified yet.
+        if (recording_ && index + 1 == strokes_.size()) {
+            out.insert(out.end(), pending_.begin() + 1, pending_.end());
+        }
+    }
+
+    void StrokeRecorder::draw() const {
+        if (!globalCanvas) return;
+        draw(Rect(0, 0, globalCanvas->getWidth(), globalCanvas->getHeight()));
+    }
+
+    void StrokeRecorder::draw(const Rect& area) const {
+        for (size_t i = 0; i < strokes_.size(); ++i) {
+            const Stroke& stroke = strokes_[i];
+            if (!overlaps(stroke.bounds, area)) continue;
+
+            getPoints(i, scratch_);
+            if (scratch_.size() == 1) {
+                Draw::circle(scratch_[0].x, scratch_[0].y, stroke.size, stroke.color);
+                continue;
+            }
+            Draw::polyline(scratch_, 2 * stroke.size + 1, LineJoin::Round, LineCap::Round, stroke.color);
+        }
+    }
+
+    int StrokeRecorder::hitTest(int x, int y, int slop) const {
+        Point point(x, y);
+        Rect probe(x - slop, y - slop, 2 * slop + 1, 2 * slop + 1);
+        for (size_t i = strokes_.size(); i-- > 0;) {
+            const Stroke& stroke = strokes_[i];
+            if (!overlaps(stroke.bounds, probe)) continue;
+
+            getPoints(i, scratch_);
+            float reach = (float)(stroke.size + slop);
+            float limit = reach * reach;
+            if (scratch_.size() == 1 && distanceSquared(point, scratch_[0], scratch_[0]) <= limit) {
+                return (int)i;
+            }
+            for (size_t k = 1; k < scratch_.size(); ++k) {
+                if (distanceSquared(point, scratch_[k - 1], scratch_[k]) <= limit) return (int)i;
+            }
+        }
+        return -1;
+    }
+
+    size_t StrokeRecorder::bytes() const {
+        return data_.capacity() + strokes_.capacity() * sizeof(Stroke) +
+               pending_.capacity() * sizeof(Point);
+    }
+}
@@ -1,20 +1,150 @@
 #include "../../include/fern/text/font.hpp"
 #include "../../include/fern/core/canvas.hpp"
+#include "../../include/fern/graphics/colors.hpp"
 #include "font_data.hpp"
 #include <cstring>
+#include <list>
+#include <unordered_map>
+#include <vector>
 
 namespace Fern {
     namespace Text {
+        static bool smoothing = false;
+        
+        // Coverage mask for one glyph at one scale, (8 * scale)^2 bytes.
+        struct GlyphMask {
+            int size = 0;
+            std::vector<uint8_t> coverage;
+        };
+        
+        // Least recently used masks are dropped once the cache holds more
+        // than MAX_MASK_BYTES of coverage; one glyph at scale 16 is 16 KB.
+        static const size_t MAX_MASK_BYTES = 1024 * 1024;
+        using MaskEntry = std::pair<uint32_t, GlyphMask>;
+        static std::list<MaskEntry> maskEntries;       // most recently used first
+        static std::unordered_map<uint32_t, std::list<MaskEntry>::iterator> maskIndex;
+        static size_t maskBytes = 0;
+        // Holds a mask too large to cache until the next one is built.
+        static GlyphMask uncachedMask;
+        
+        static int glyphIndex(char c) {
+            if (c >= 'A' && c <= 'Z') return c - 'A';
+            if (c >= '0' && c <= '9') return 26 + (c - '0');
+            return -1;
+        }
+        
+        static float glyphBit(int index, int col, int row) {
+            if (col < 0 || col >= 8 || row < 0 || row >= 8) return 0.0f;
+            return (FontData::SIMPLE_FONT[index][row] & (1 << (7 - col))) ? 1.0f : 0.0f;
+        }
+        
+        // Bilinear interpolation of the 1-bit glyph, in glyph cell units.
+        static float sampleGlyph(int index, float gx, float gy) {
+            gx -= 0.5f;
+            gy -= 0.5f;
+            int x0 = gx < 0.0f ? -1 : (int)gx;
+            int y0 = gy < 0.0f ? -1 : (int)gy;
+            float fx = gx - x0;
+            float fy = gy - y0;
+            
+            float top = glyphBit(index, x0, y0) * (1.0f - fx) + glyphBit(index, x0 + 1, y0) * fx;
+            float bottom = glyphBit(index, x0, y0 + 1) * (1.0f - fx) + glyphBit(index, x0 + 1, y0 + 1) * fx;
+            return top * (1.0f - fy) + bottom * fy;
+        }
+        
+        // The glyph outline is the 0.5 contour of the bilinear field: straight
+        // edges stay on cell boundaries while staircases become diagonals.
+        // Coverage is that outline supersampled 4x4 per output pixel.
+        static void buildGlyphMask(GlyphMask& mask, int index, int scale) {
+            const int samples = 4;
+            mask.size = 8 * scale;
+            mask.coverage.resize(mask.size * mask.size);
+            
+            for (int py = 0; py < mask.size; py++) {
+                for (int px = 0; px < mask.size; px++) {
+                    int inside = 0;
+                    for (int sy = 0; sy < samples; sy++) {
+                        for (int sx = 0; sx < samples; sx++) {
+                            float gx = (px + (sx + 0.5f) / samples) / scale;
+                            float gy = (py + (sy + 0.5f) / samples) / scale;
+                            if (sampleGlyph(index, gx, gy) >= 0.5f) inside++;
+                        }
+                    }
+                    mask.coverage[py * mask.size + px] =
+                        (uint8_t)((inside * 255 + samples * samples / 2) / (samples * samples));
+                }
+            }
+        }
+        
+        // The returned mask stays valid until the next call.
+        static const GlyphMask& glyphMask(int index, int scale) {
+            uint32_t key = ((uint32_t)scale << 8) | (uint32_t)index;
+            auto found = maskIndex.find(key);
+            if (found != maskIndex.end()) {
+                maskEntries.splice(maskEntries.begin(), maskEntries, found->second);
+                return found->second->second;
+            }
+            
+            size_t bytes = (size_t)(8 * scale) * (8 * scale);
+            if (bytes > MAX_MASK_BYTES) {
+                buildGlyphMask(uncachedMask, index, scale);
+                return uncachedMask;
+            }
+            
+            while (maskBytes + bytes > MAX_MASK_BYTES && !maskEntries.empty()) {
+                maskBytes -= maskEntries.back().second.coverage.size();
+                maskIndex.erase(maskEntries.back().first);
+                maskEntries.pop_back();
+            }
+            maskEntries.emplace_front(key, GlyphMask());
+            maskIndex[key] = maskEntries.begin();
+            maskBytes += bytes;
+            GlyphMask& mask = maskEntries.front().second;
+            buildGlyphMask(mask, index, scale);
+            return mask;
+        }
+        
+        static void drawSmoothChar(int index, int x, int y, int scale, uint32_t color) {
+            const GlyphMask& mask = glyphMask(index, scale);
+            int width = globalCanvas->getWidth();
+            int height = globalCanvas->getHeight();
+            uint32_t* buffer = globalCanvas->getBuffer();
+            
+            int x0 = x < 0 ? -x : 0;
+            int y0 = y < 0 ? -y : 0;
+            int x1 = x + mask.size > width ? width - x : mask.size;
+            int y1 = y + mask.size > height ? height - y : mask.size;
+            
+            for (int row = y0; row < y1; row++) {
+                const uint8_t* coverage = &mask.coverage[row * mask.size];
+                uint32_t* dst = buffer + (y + row) * width + x;
+                for (int col = x0; col < x1; col++) {
+                    uint32_t alpha = coverage[col];
+                    if (alpha == 255) {
+                        dst[col] = color;
+                    } else if (alpha != 0) {
+                        dst[col] = Colors::blendAlpha(dst[col], color, alpha);
+                    }
+                }
+            }
+        }
+        
+        void setSmoothing(bool enabled) {
+            smoothing = enabled;
+        }
+        
+        bool isSmoothing() {
+            return smoothing;
+        }
+        
         void drawChar(char c, int x, int y, int scale, uint32_t color) {
             if (!globalCanvas) return;
             
-            int char_index;
+            int char_index = glyphIndex(c);
+            if (char_index < 0) return;
             
-            if (c >= 'A' && c <= 'Z') {
-                char_index = c - 'A';
-            } else if (c >= '0' && c <= '9') {
-                char_index = 26 + (c - '0');
-            } else {
+            if (smoothing && scale > 1) {
+                drawSmoothChar(char_index, x, y, scale, color);
                 return;
             }
             
@@ -55,4 +185,4 @@ namespace Fern {
             }
         }
     }
-}
\ No newline at end of file
+}
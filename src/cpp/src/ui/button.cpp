@@ -3,6 +3,7 @@
 #include "../../include/fern/core/widget_manager.hpp"
 #include "../../include/fern/graphics/primitives.hpp"
 #include "../../include/fern/text/font.hpp"
+#include "../core/widget_pool.hpp"
 #include <cstring>
 #include <memory>
 namespace Fern {
@@ -15,7 +16,8 @@ namespace Fern {
             buttonColor = isPressed_ ? config_.pressColor : config_.hoverColor;
         }
         
-        Draw::rect(config_.x, config_.y, config_.width, config_.height, buttonColor);
+        Draw::roundedRect(config_.x, config_.y, config_.width, config_.height,
+                          config_.cornerRadius, buttonColor);
         
         if (!config_.label.empty()) {
             int textWidth = config_.label.length() * 8 * config_.textScale;
@@ -27,14 +29,17 @@ namespace Fern {
     }        const auto& input = Input::getState();
 
     
+    bool Button::getBounds(Rect& bounds) const {
+        bounds = Rect(config_.x, config_.y, config_.width, config_.height);
+        return true;
+    }
+    
     bool Button::handleInput(const InputState& input) {
         bool wasHovered = isHovered_;
         bool wasPressed = isPressed_;
 
-        isHovered_ = input.mouseX >= config_.x && 
-                     input.mouseX < config_.x + config_.width &&
-                     input.mouseY >= config_.y &&
-                     input.mouseY < config_.y + config_.height;
+        isHovered_ = Rect(config_.x, config_.y, config_.width, config_.height)
+                         .contains(input.mouseX, input.mouseY);
         
         isPressed_ = isHovered_ && input.mouseDown;
         
@@ -55,7 +60,7 @@ namespace Fern {
     }
     
     std::shared_ptr<Button> ButtonWidget(const ButtonConfig& config) {
-        auto button = std::make_shared<Button>(config);
+        auto button = WidgetPool::make<Button>(config);
         if (config.onClick) {
             button->onClick.connect(config.onClick);
         }
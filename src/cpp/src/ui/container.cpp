@@ -1,6 +1,11 @@
 #include "../../include/fern/ui/container.hpp"
 #include "../../include/fern/graphics/primitives.hpp"
 #include "../../include/fern/core/canvas.hpp"
+#include "../../include/fern/core/thread_pool.hpp"
+#include "../../include/fern/core/widget_manager.hpp"
+#include "../core/widget_pool.hpp"
+#include <algorithm>
+#include <vector>
 
 namespace Fern {
     Container::Container(int x, int y, int width, int height, uint32_t color)
@@ -10,6 +15,17 @@ namespace Fern {
         Draw::rect(x_, y_, width_, height_, color_);
     }
     
+    bool Container::getBounds(Rect& bounds) const {
+        bounds = Rect(x_, y_, width_, height_);
+        return true;
+    }
+    
+    std::shared_ptr<Container> ContainerWidget(int x, int y, int width, int height, uint32_t color) {
+        auto container = WidgetPool::make<Container>(x, y, width, height, color);
+        addWidget(container);
+        return container;
+    }
+    
     void BasicContainer(uint32_t color, int x, int y, int width, int height) {
         Fern::Container container(x, y, width, height, color);
         container.render();
@@ -25,20 +41,36 @@ namespace Fern {
     }
     
     void LinearGradientContainer(int x, int y, int width, int height, const LinearGradient& gradient) {
-        if (!globalCanvas) return;
+        if (!globalCanvas || width <= 0 || height <= 0) return;
+        
+        int canvasWidth = globalCanvas->getWidth();
+        uint32_t* buffer = globalCanvas->getBuffer();
+        int x0 = std::max(x, 0);
+        int x1 = std::min(x + width, canvasWidth);
+        int y0 = std::max(y, 0);
+        int y1 = std::min(y + height, globalCanvas->getHeight());
+        if (x0 >= x1 || y0 >= y1) return;
         
         if (gradient.isVertical()) {
-            for (int row = 0; row < height; row++) {
-                float pos = (float)row / height;
-                uint32_t color = gradient.colorAt(pos);
-                Draw::rect(x, y + row, width, 1, color);
-            }
+            parallelForRows(y0, y1, 32, [&](int rowBegin, int rowEnd) {
+                for (int py = rowBegin; py < rowEnd; py++) {
+                    float pos = (float)(py - y) / height;
+                    uint32_t color = gradient.colorAt(pos);
+                    std::fill(buffer + py * canvasWidth + x0, buffer + py * canvasWidth + x1, color);
+                }
+            });
         } else {
-            for (int col = 0; col < width; col++) {
-                float pos = (float)col / width;
-                uint32_t color = gradient.colorAt(pos);
-                Draw::rect(x + col, y, 1, height, color);
+            // Every row is identical: evaluate the gradient once, then copy.
+            std::vector<uint32_t> row(x1 - x0);
+            for (int px = x0; px < x1; px++) {
+                float pos = (float)(px - x) / width;
+                row[px - x0] = gradient.colorAt(pos);
             }
+            parallelForRows(y0, y1, 32, [&](int rowBegin, int rowEnd) {
+                for (int py = rowBegin; py < rowEnd; py++) {
+                    std::copy(row.begin(), row.end(), buffer + py * canvasWidth + x0);
+                }
+            });
         }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "fern/core/canvas.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// Minimal check macros for the test executables. A failed check prints its
+// location and the test keeps going, so one run reports every failure.
+namespace FernTest {
+    inline int& failures() {
+        static int count = 0;
+        return count;
+    }
+
+    inline void fail(const char* file, int line, const char* expression) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+        failures()++;
+    }
+
+    // Returns the process exit code.
+    inline int finish(const char* name) {
+        if (failures() == 0) {
+            std::printf("%s: ok\n", name);
+            return 0;
+        }
+        std::printf("%s: %d failed\n", name, failures());
+        return 1;
+    }
+
+    // Pixel buffer installed as globalCanvas for the lifetime of the object.
+    class TestCanvas {
+    public:
+        TestCanvas(int width, int height)
+            : pixels_((size_t)width * height, 0), canvas_(pixels_.data(), width, height) {
+            previous_ = Fern::globalCanvas;
+            Fern::globalCanvas = &canvas_;
+        }
+        ~TestCanvas() { Fern::globalCanvas = previous_; }
+
+        void clear() { pixels_.assign(pixels_.size(), 0); }
+        uint32_t at(int x, int y) const { return pixels_[(size_t)y * canvas_.getWidth() + x]; }
+        int width() const { return canvas_.getWidth(); }
+        int height() const { return canvas_.getHeight(); }
+        const std::vector<uint32_t>& pixels() const { return pixels_; }
+        Fern::Canvas& canvas() { return canvas_; }
+
+    private:
+        std::vector<uint32_t> pixels_;
+        Fern::Canvas canvas_;
+        Fern::Canvas* previous_;
+    };
+}
+
+#define CHECK(expression) \
+    do { \
+        if (!(expression)) FernTest::fail(__FILE__, __LINE__, #expression); \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    do { \
+        if (!((actual) == (expected))) FernTest::fail(__FILE__, __LINE__, #actual " == " #expected); \
+    } while (0)
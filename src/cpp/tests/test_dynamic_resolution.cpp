@@ -0,0 +1,96 @@
+#include "fern/core/dynamic_resolution.hpp"
+#include "test.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+using namespace Fern;
+
+namespace {
+    // Odd sizes: the presented width leaves a tail after the 4-pixel SIMD
+    // groups, and the scaled sizes round.
+    const int W = 203, H = 117;
+
+    // Scalar bilinear filter, written out independently of the library:
+    // pixel centers aligned, 8-bit weights, each channel rounded down after
+    // the horizontal and again after the vertical blend.
+    void position(int i, int srcSize, int dstSize, int& i0, int& i1, int& weight) {
+        double s = (i + 0.5) * srcSize / dstSize - 0.5;
+        if (s <= 0.0) {
+            i0 = i1 = 0;
+            weight = 0;
+            return;
+        }
+        i0 = std::min((int)s, srcSize - 1);
+        i1 = std::min(i0 + 1, srcSize - 1);
+        weight = (int)((s - i0) * 256.0 + 0.5);
+    }
+
+    uint32_t blend(uint32_t a, uint32_t b, int weight) {
+        uint32_t result = 0;
+        for (int shift = 0; shift < 32; shift += 8) {
+            uint32_t ca = (a >> shift) & 0xFF, cb = (b >> shift) & 0xFF;
+            result |= ((ca * (256 - weight) + cb * weight) >> 8) << shift;
+        }
+        return result;
+    }
+
+    std::vector<uint32_t> reference(const std::vector<uint32_t>& src, int sw, int sh) {
+        std::vector<uint32_t> out((size_t)W * H);
+        for (int y = 0; y < H; ++y) {
+            int r0, r1, wy;
+            position(y, sh, H, r0, r1, wy);
+            for (int x = 0; x < W; ++x) {
+                int c0, c1, wx;
+                position(x, sw, W, c0, c1, wx);
+                uint32_t upper = blend(src[(size_t)r0 * sw + c0], src[(size_t)r0 * sw + c1], wx);
+                uint32_t lower = blend(src[(size_t)r1 * sw + c0], src[(size_t)r1 * sw + c1], wx);
+                out[(size_t)y * W + x] = blend(upper, lower, wy);
+            }
+        }
+        return out;
+    }
+
+    // Slow frames until the scale drops one level.
+    void stepDown() {
+        float scale = DynamicResolution::getScale();
+        while (DynamicResolution::getScale() == scale) DynamicResolution::recordFrameTime(100.0);
+    }
+
+    // At each reduced scale, random content upscaled with the bilinear
+    // filter matches the scalar reference exactly, tail columns and the
+    // clamped last row and column included.
+    void testBilinearMatchesScalar() {
+        FernTest::TestCanvas screen(W, H);
+        DynamicResolution::setEnabled(true);
+        DynamicResolution::setTargetFrameTime(1.0);
+        DynamicResolution::setMinimumScale(0.5f);
+        DynamicResolution::setFilter(UpscaleFilter::Bilinear);
+        std::srand(3);
+
+        for (int level = 0; level < 2; ++level) {
+            stepDown();
+            DynamicResolution::beginFrame();
+            Canvas* internal = globalCanvas;
+            CHECK(internal != &screen.canvas());
+            int sw = internal->getWidth(), sh = internal->getHeight();
+            CHECK_EQ(sw, (int)std::lround(W * DynamicResolution::getScale()));
+
+            std::vector<uint32_t> source((size_t)sw * sh);
+            for (uint32_t& pixel : source) {
+                pixel = (uint32_t)std::rand() << 16 ^ (uint32_t)std::rand();
+            }
+            std::copy(source.begin(), source.end(), internal->getBuffer());
+            DynamicResolution::endFrame();
+            CHECK(globalCanvas == &screen.canvas());
+
+            CHECK(screen.pixels() == reference(source, sw, sh));
+        }
+        DynamicResolution::setEnabled(false);
+    }
+}
+
+int main() {
+    testBilinearMatchesScalar();
+    return FernTest::finish("dynamic_resolution");
+}
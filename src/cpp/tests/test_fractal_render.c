@@ -0,0 +1,135 @@
+// Fractal explorer renderer (examples/c/fractal_render.h): the tile pool and
+// the iteration cache.
+#include "fractal_render.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#define WIDTH 160
+#define HEIGHT 120
+
+static int failures = 0;
+
+#define CHECK(expression) \
+    do { \
+        if (!(expression)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #expression); \
+            failures++; \
+        } \
+    } while (0)
+
+static FractalView random_view(void) {
+    FractalView view;
+    view.center_x = -0.75 + (rand() % 1000) / 2000.0;
+    view.center_y = (rand() % 1000) / 2000.0 - 0.25;
+    view.scale = 0.002 + (rand() % 100) / 20000.0;
+    view.width = WIDTH;
+    view.height = HEIGHT;
+    view.max_iterations = 32 + rand() % 200;
+    return view;
+}
+
+// Many small jobs back to back, each into its own buffer with its own view,
+// so a tile claimed against the wrong job shows up as wrong or missing
+// counts.
+static void test_back_to_back_jobs(void) {
+    static int parallel[4][WIDTH * HEIGHT];
+    static int serial[WIDTH * HEIGHT];
+    int mismatches = 0;
+
+    srand(1);
+    for (int round = 0; round < 3000; round++) {
+        FractalView view = random_view();
+        int* out = parallel[round % 4];
+        int x0 = rand() % WIDTH, y0 = rand() % HEIGHT;
+        int x1 = x0 + 1 + rand() % (WIDTH - x0);
+        int y1 = y0 + 1 + rand() % (HEIGHT - y0);
+        if (round % 2) {
+            // Mostly one or two tiles, to finish as fast as a worker wakes.
+            x1 = x0 + 1 + (x1 - x0) % 40;
+            y1 = y0 + 1 + (y1 - y0) % 40;
+            if (x1 > WIDTH) x1 = WIDTH;
+            if (y1 > HEIGHT) y1 = HEIGHT;
+        }
+
+        for (int i = 0; i < WIDTH * HEIGHT; i++)
+            out[i] = serial[i] = -1;
+        fractal_compute_parallel(&view, out, x0, y0, x1, y1);
+        fractal_compute_rect(&view, serial, x0, y0, x1, y1);
+        if (memcmp(out, serial, sizeof(serial)) != 0)
+            mismatches++;
+    }
+    CHECK(mismatches == 0);
+}
+
+static int shade(int iterations) {
+    return iterations * 2654435 + 1;
+}
+
+static void shade_rect(const FractalCache* cache, int* image, int x0, int y0, int x1, int y1) {
+    for (int y = y0; y < y1; y++) {
+        for (int x = x0; x < x1; x++)
+            image[y * WIDTH + x] = shade(cache->iters[y * WIDTH + x]);
+    }
+}
+
+// Pans, zooms and limit changes: an image kept up to date from the reported
+// changes alone matches one derived from the whole field after every update.
+static void test_cache_changes(void) {
+    static int iters[WIDTH * HEIGHT], scratch[WIDTH * HEIGHT];
+    static int image[WIDTH * HEIGHT], expected[WIDTH * HEIGHT];
+    FractalCache cache;
+    fractal_cache_init(&cache, iters, scratch, WIDTH * HEIGHT);
+
+    FractalView view = { -0.5, 0.0, 3.0 / HEIGHT, WIDTH, HEIGHT, 100 };
+    int image_mismatches = 0;
+
+    srand(2);
+    for (int step = 0; step < 400; step++) {
+        int action = rand() % 10;
+        if (action < 7) {
+            view.center_x += (rand() % 41 - 20) * view.scale;
+            view.center_y += (rand() % 41 - 20) * view.scale;
+        } else if (action == 7) {
+            view.center_x += (rand() % 3 - 1) * WIDTH * view.scale;
+        } else if (action == 8) {
+            view.scale *= rand() % 2 ? 0.8 : 1.25;
+        } else {
+            view.max_iterations = 40 + rand() % 100;
+        }
+
+        // Unlimited budget: refinement finishes within the update.
+        fractal_cache_update(&cache, &view, 1e9);
+        if (cache.changed_all) {
+            shade_rect(&cache, image, 0, 0, WIDTH, HEIGHT);
+        } else {
+            int dx = cache.moved_x, dy = cache.moved_y;
+            fractal_shift_pixels(image, WIDTH, HEIGHT, dx, dy);
+            if (dy > 0)
+                shade_rect(&cache, image, 0, HEIGHT - dy, WIDTH, HEIGHT);
+            else if (dy < 0)
+                shade_rect(&cache, image, 0, 0, WIDTH, -dy);
+            if (dx > 0)
+                shade_rect(&cache, image, WIDTH - dx, 0, WIDTH, HEIGHT);
+            else if (dx < 0)
+                shade_rect(&cache, image, 0, 0, -dx, HEIGHT);
+            shade_rect(&cache, image, 0, cache.dirty_y0, WIDTH, cache.dirty_y1);
+        }
+
+        shade_rect(&cache, expected, 0, 0, WIDTH, HEIGHT);
+        if (memcmp(image, expected, sizeof(image)) != 0)
+            image_mismatches++;
+
+    }
+    CHECK(image_mismatches == 0);
+}
+
+int main(void) {
+    test_back_to_back_jobs();
+    test_cache_changes();
+    if (failures) {
+        printf("fractal_render: %d failed\n", failures);
+        return 1;
+    }
+    printf("fractal_render: ok\n");
+    return 0;
+}
@@ -0,0 +1,211 @@
+#include "fern/core/input.hpp"
+#include "fern/core/widget_manager.hpp"
+#include "test.hpp"
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace Fern;
+
+namespace {
+    std::vector<InputEventType> types() {
+        std::vector<InputEventType> result;
+        for (const InputEvent& event : Input::getEvents()) result.push_back(event.type);
+        return result;
+    }
+
+    // Updates that leave the state as it was are not events.
+    void testDuplicatesDropped() {
+        Input::updateMousePosition(10, 20);
+        Input::updateMousePosition(10, 20);
+        Input::updateMouseButton(false);
+        Input::pollEvents();
+        CHECK_EQ(Input::getEvents().size(), 1u);
+        CHECK(types()[0] == InputEventType::Move);
+        CHECK_EQ(Input::getState().mouseX, 10);
+        CHECK_EQ(Input::getState().mouseY, 20);
+        Input::resetEvents();
+
+        Input::updateMousePosition(10, 20);
+        Input::pollEvents();
+        CHECK(!Input::hasEvents());
+        Input::resetEvents();
+
+        Input::updateMouseButton(true);
+        Input::updateMouseButton(true);
+        Input::pollEvents();
+        CHECK_EQ(Input::getEvents().size(), 2u);
+        Input::resetEvents();
+
+        Input::updateMouseButton(false);
+        Input::updateMouseButton(false);
+        Input::pollEvents();
+        CHECK_EQ(Input::getEvents().size(), 1u);
+        CHECK(types()[0] == InputEventType::Up);
+        CHECK(!Input::getState().mouseDown);
+        Input::resetEvents();
+    }
+
+    // A press is recorded as Down followed by Click, in arrival order with
+    // the moves around it, and sets mouseClicked for that frame only.
+    void testDownBeforeClick() {
+        Input::updateMousePosition(1, 1);
+        Input::updateMouseButton(true);
+        Input::updateMousePosition(2, 2);
+        Input::updateMouseButton(false);
+        Input::pollEvents();
+        std::vector<InputEventType> expected{InputEventType::Move, InputEventType::Down,
+                                             InputEventType::Click, InputEventType::Move,
+                                             InputEventType::Up};
+        CHECK(types() == expected);
+        CHECK_EQ(Input::getEvents()[1].x, 1);
+        CHECK(Input::getState().mouseClicked);
+        CHECK(!Input::getState().mouseDown);
+        Input::resetEvents();
+
+        Input::pollEvents();
+        CHECK(!Input::getState().mouseClicked);
+        Input::resetEvents();
+    }
+
+    // Every position queued while the button is held becomes a segment,
+    // starting from where the pointer was at the start of the frame.
+    void testDragSegments() {
+        Input::updateMousePosition(0, 0);
+        Input::pollEvents();
+        Input::resetEvents();
+
+        Input::updateMousePosition(5, 0);
+        Input::updateMouseButton(true);
+        for (int i = 1; i <= 20; ++i) Input::updateMousePosition(5 + i, i);
+        Input::updateMouseButton(false);
+        Input::updateMousePosition(100, 100);
+        Input::pollEvents();
+
+        std::vector<Point> from, to;
+        Input::forEachDragSegment([&](Point a, Point b) {
+            from.push_back(a);
+            to.push_back(b);
+        });
+        CHECK_EQ(from.size(), 20u);
+        bool chained = true;
+        for (size_t i = 0; i < from.size(); ++i) {
+            chained &= to[i].x == 6 + (int)i && to[i].y == 1 + (int)i;
+            chained &= from[i].x == (i ? to[i - 1].x : 5) && from[i].y == (i ? to[i - 1].y : 0);
+        }
+        CHECK(chained);
+        Input::resetEvents();
+
+        // A drag already in progress continues from the frame's start.
+        Input::updateMouseButton(true);
+        Input::pollEvents();
+        Input::resetEvents();
+        Input::updateMousePosition(101, 100);
+        Input::updateMousePosition(102, 100);
+        Input::pollEvents();
+        int segments = 0;
+        Input::forEachDragSegment([&](Point a, Point b) {
+            CHECK_EQ(a.x, 100 + segments);
+            CHECK_EQ(b.x, 101 + segments);
+            segments++;
+        });
+        CHECK_EQ(segments, 2);
+        Input::resetEvents();
+        Input::updateMouseButton(false);
+        Input::pollEvents();
+        Input::resetEvents();
+    }
+
+    void testCoalesceMoves() {
+        auto event = [](InputEventType type, int x) {
+            InputEvent e;
+            e.type = type;
+            e.x = x;
+            return e;
+        };
+        std::vector<InputEvent> events{
+            event(InputEventType::Move, 1), event(InputEventType::Move, 2),
+            event(InputEventType::Down, 2), event(InputEventType::Click, 2),
+            event(InputEventType::Move, 3), event(InputEventType::Move, 4),
+            event(InputEventType::Move, 5), event(InputEventType::Up, 5),
+            event(InputEventType::Move, 6)};
+        Input::coalesceMoves(events);
+
+        std::vector<int> xs;
+        for (const InputEvent& e : events) xs.push_back(e.x);
+        CHECK(xs == (std::vector<int>{2, 2, 2, 5, 5, 6}));
+        CHECK(events[0].type == InputEventType::Move);
+        CHECK(events[3].type == InputEventType::Move);
+
+        std::vector<InputEvent> empty;
+        Input::coalesceMoves(empty);
+        CHECK(empty.empty());
+    }
+
+    // Events from another thread arrive in order with increasing
+    // timestamps; whatever does not fit in the ring is counted.
+    void testProducerThread() {
+        const int MOVES = 3000;
+        size_t droppedBefore = Input::getDroppedEventCount();
+        std::thread producer([] {
+            for (int i = 1; i <= MOVES; ++i) Input::updateMousePosition(i, 0);
+        });
+        producer.join();
+        Input::pollEvents();
+
+        const std::vector<InputEvent>& events = Input::getEvents();
+        size_t dropped = Input::getDroppedEventCount() - droppedBefore;
+        CHECK_EQ(events.size() + dropped, (size_t)MOVES);
+        bool ordered = true;
+        for (size_t i = 1; i < events.size(); ++i) {
+            ordered &= events[i].x == events[i - 1].x + 1;
+            ordered &= events[i].timestamp >= events[i - 1].timestamp;
+        }
+        CHECK(ordered);
+        Input::resetEvents();
+    }
+
+    struct Counter : Widget {
+        int updates = 0;
+        void render() override {}
+        bool handleInput(const InputState&) override { updates++; return false; }
+    };
+
+    // Frames without events do no dispatch, even for widgets that otherwise
+    // receive every update.
+    void testIdleFramesSkipDispatch() {
+        WidgetManager& manager = WidgetManager::getInstance();
+        auto counter = std::make_shared<Counter>();
+        WidgetHandle handle = manager.addWidget(counter);
+
+        auto frame = [&] {
+            Input::pollEvents();
+            manager.processInput();
+            Input::resetEvents();
+        };
+        frame();    // the widget set changed
+        CHECK_EQ(counter->updates, 1);
+        for (int i = 0; i < 10; ++i) frame();
+        CHECK_EQ(counter->updates, 1);
+
+        Input::updateMousePosition(30, 30);
+        frame();
+        CHECK_EQ(counter->updates, 2);
+        Input::updateMousePosition(30, 30);
+        frame();
+        CHECK_EQ(counter->updates, 2);
+
+        manager.removeWidget(handle);
+        frame();
+    }
+}
+
+int main() {
+    testDuplicatesDropped();
+    testDownBeforeClick();
+    testIdleFramesSkipDispatch();
+    testDragSegments();
+    testCoalesceMoves();
+    testProducerThread();
+    return FernTest::finish("input");
+}
@@ -0,0 +1,152 @@
+#include "fern/graphics/colors.hpp"
+#include "fern/graphics/layers.hpp"
+#include "fern/graphics/primitives.hpp"
+#include "test.hpp"
+#include <cstdlib>
+#include <vector>
+
+using namespace Fern;
+
+namespace {
+    const int WIDTH = 500;      // not a multiple of the tile size
+    const int HEIGHT = 300;
+
+    std::vector<uint32_t> contents(Layer& layer) {
+        const uint32_t* pixels = layer.getCanvas().getBuffer();
+        return std::vector<uint32_t>(pixels, pixels + WIDTH * HEIGHT);
+    }
+
+    void paintDab(Compositor& compositor, int step) {
+        int x = (step * 173) % WIDTH, y = (step * 97) % HEIGHT;
+        compositor.paint("ink", Rect(x - 12, y - 12, 25, 25), [&] {
+            Draw::circle(x, y, 10, 0xFF000000 | (uint32_t)(step * 5003));
+        });
+    }
+
+    // Undo and redo reproduce every committed state exactly.
+    void testHistory() {
+        FernTest::TestCanvas screen(WIDTH, HEIGHT);
+        Compositor compositor(WIDTH, HEIGHT);
+        Layer& ink = compositor.addLayer("ink");
+        LayerHistory history(ink, 100);
+
+        std::vector<std::vector<uint32_t>> states{contents(ink)};
+        for (int step = 1; step <= 40; ++step) {
+            paintDab(compositor, step);
+            history.commit();
+            states.push_back(contents(ink));
+        }
+
+        bool exact = true;
+        for (int s = 39; s >= 0; --s) {
+            CHECK(history.undo());
+            exact &= contents(ink) == states[s];
+        }
+        CHECK(!history.canUndo());
+        CHECK(!history.undo());
+        for (int s = 1; s <= 40; ++s) {
+            CHECK(history.redo());
+            exact &= contents(ink) == states[s];
+        }
+        CHECK(!history.canRedo());
+        CHECK(exact);
+
+        // A new edit after undoing drops the redo branch.
+        history.undo();
+        paintDab(compositor, 99);
+        history.commit();
+        CHECK(!history.canRedo());
+        history.undo();
+        CHECK(contents(ink) == states[39]);
+    }
+
+    // The oldest steps fall off once depth is reached.
+    void testHistoryDepth() {
+        FernTest::TestCanvas screen(WIDTH, HEIGHT);
+        Compositor compositor(WIDTH, HEIGHT);
+        Layer& ink = compositor.addLayer("ink");
+        LayerHistory history(ink, 4);
+        for (int step = 1; step <= 10; ++step) {
+            paintDab(compositor, step);
+            history.commit();
+        }
+        int undos = 0;
+        while (history.undo()) undos++;
+        CHECK_EQ(undos, 4);
+    }
+
+    void testSnapshotRestore() {
+        FernTest::TestCanvas screen(WIDTH, HEIGHT);
+        Compositor compositor(WIDTH, HEIGHT);
+        Layer& ink = compositor.addLayer("ink");
+        paintDab(compositor, 1);
+        LayerSnapshot saved = ink.snapshot();
+        std::vector<uint32_t> expected = contents(ink);
+
+        ink.clear(0xFF123456);
+        paintDab(compositor, 2);
+        ink.restore(saved);
+        CHECK(saved.isValid());
+        CHECK(contents(ink) == expected);
+
+        // Snapshots only restore into the layer they came from.
+        Layer& other = compositor.addLayer("other");
+        other.clear(0xFF00FF00);
+        other.restore(saved);
+        CHECK_EQ(other.getCanvas().getPixel(0, 0), 0xFF00FF00u);
+    }
+
+    // Composited output matches blending every layer over the background
+    // pixel by pixel, after several rounds of partial updates.
+    void testComposite() {
+        FernTest::TestCanvas screen(WIDTH, HEIGHT);
+        const uint32_t background = 0xFF202020;
+        Compositor compositor(WIDTH, HEIGHT, background);
+        Layer& bottom = compositor.addLayer("bottom");
+        compositor.addLayer("ink");
+        Layer& top = compositor.addLayer("top");
+        top.setOpacity(0.5f);
+
+        std::srand(11);
+        for (int round = 0; round < 5; ++round) {
+            compositor.paint("bottom", Rect(0, 0, WIDTH, HEIGHT), [&] {
+                Draw::rect(std::rand() % WIDTH, std::rand() % HEIGHT, 80, 60, 0xFF0000FF);
+            });
+            paintDab(compositor, round);
+            compositor.paint("top", Rect(0, 0, WIDTH, HEIGHT), [&] {
+                Draw::circle(std::rand() % WIDTH, std::rand() % HEIGHT, 40, 0xFFFF0000);
+            });
+            if (round == 3) bottom.setVisible(false);
+            compositor.composite();
+
+            bool match = true;
+            for (int y = 0; y < HEIGHT; ++y) {
+                for (int x = 0; x < WIDTH; ++x) {
+                    uint32_t expected = background;
+                    for (const char* name : {"bottom", "ink", "top"}) {
+                        Layer* layer = compositor.getLayer(name);
+                        if (!layer->isVisible()) continue;
+                        uint32_t src = layer->getCanvas().getPixel(x, y);
+                        uint32_t opacity = (uint32_t)(layer->getOpacity() * 255.0f + 0.5f);
+                        uint32_t alpha = ((src >> 24) * opacity + 127) / 255;
+                        if (alpha == 255) {
+                            expected = src;
+                        } else if (alpha > 0) {
+                            expected = Colors::blendAlpha(expected, src, alpha) | 0xFF000000;
+                        }
+                    }
+                    match &= screen.at(x, y) == expected;
+                }
+            }
+            CHECK(match);
+        }
+    }
+}
+
+int main() {
+    testHistory();
+    testHistoryDepth();
+    testSnapshotRestore();
+    testComposite();
+    return FernTest::finish("layers");
+}
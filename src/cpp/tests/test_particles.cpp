@@ -0,0 +1,182 @@
+#include "fern/core/particles.hpp"
+#include "test.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <map>
+#include <vector>
+
+using namespace Fern;
+
+namespace {
+    struct Particle {
+        float x, y, vx, vy;
+        int type;
+    };
+
+    float random(float range) {
+        return (float)std::rand() / RAND_MAX * range;
+    }
+
+    // One tick computed over every pair, straight from the rules.
+    std::vector<Particle> bruteForceStep(const std::vector<Particle>& in, const ParticleRules& r,
+                                         float width, float height) {
+        std::vector<Particle> out = in;
+        float sweet = r.interactionRadius * 0.5f;
+        for (size_t i = 0; i < in.size(); ++i) {
+            float fx = 0.0f, fy = 0.0f;
+            for (size_t j = 0; j < in.size(); ++j) {
+                float dx = in[j].x - in[i].x, dy = in[j].y - in[i].y;
+                if (r.wrapEdges) {
+                    if (dx > width * 0.5f) dx -= width;
+                    if (dx < -width * 0.5f) dx += width;
+                    if (dy > height * 0.5f) dy -= height;
+                    if (dy < -height * 0.5f) dy += height;
+                }
+                float d2 = dx * dx + dy * dy;
+                if (d2 >= r.interactionRadius * r.interactionRadius || d2 <= 0.01f) continue;
+                float d = std::sqrt(d2);
+                float a = r.attraction[(size_t)in[i].type * r.typeCount + in[j].type];
+                float force;
+                if (d < r.minDistance) {
+                    force = -1.0f;
+                } else if (d < sweet) {
+                    force = a * (d / sweet - 1.0f);
+                } else {
+                    force = a * (1.0f - (d - sweet) / (r.interactionRadius - sweet));
+                }
+                fx += dx / d * force * r.forceStrength;
+                fy += dy / d * force * r.forceStrength;
+            }
+
+            Particle& p = out[i];
+            p.vx = (p.vx + fx) * (1.0f - r.friction);
+            p.vy = (p.vy + fy) * (1.0f - r.friction);
+            float speed = std::sqrt(p.vx * p.vx + p.vy * p.vy);
+            if (speed > r.maxSpeed) {
+                p.vx *= r.maxSpeed / speed;
+                p.vy *= r.maxSpeed / speed;
+            }
+            p.x += p.vx;
+            p.y += p.vy;
+            if (r.wrapEdges) {
+                if (p.x < 0) p.x += width;
+                if (p.x >= width) p.x -= width;
+                if (p.y < 0) p.y += height;
+                if (p.y >= height) p.y -= height;
+            } else {
+                float low = r.wallMargin;
+                float highX = width - r.wallMargin - 1.0f, highY = height - r.wallMargin - 1.0f;
+                if (p.x < low) {
+                    p.x = low;
+                    p.vx *= -r.wallBounce;
+                } else if (p.x >= highX + 1.0f) {
+                    p.x = highX;
+                    p.vx *= -r.wallBounce;
+                }
+                if (p.y < low) {
+                    p.y = low;
+                    p.vy *= -r.wallBounce;
+                } else if (p.y >= highY + 1.0f) {
+                    p.y = highY;
+                    p.vy *= -r.wallBounce;
+                }
+            }
+        }
+        return out;
+    }
+
+    // step() reorders particles; their sizes are unique and identify them.
+    std::map<float, Particle> byId(const ParticleSystem& system) {
+        std::map<float, Particle> result;
+        for (size_t i = 0; i < system.size(); ++i) {
+            result[system.sizes()[i]] = Particle{system.positionsX()[i], system.positionsY()[i],
+                                                 system.velocitiesX()[i], system.velocitiesY()[i],
+                                                 system.types()[i]};
+        }
+        return result;
+    }
+
+    bool close(float a, float b) {
+        return std::fabs(a - b) <= 1e-3f * std::max(1.0f, std::fabs(a));
+    }
+
+    // Several ticks, each compared with the brute-force tick from the same
+    // starting state, so rounding differences in summation order cannot
+    // accumulate.
+    void checkAgainstBruteForce(ParticleRules rules, float width, float height, int count) {
+        std::srand(17);
+        rules.attraction.resize((size_t)rules.typeCount * rules.typeCount);
+        for (float& a : rules.attraction) a = random(2.0f) - 1.0f;
+
+        ParticleSystem system(width, height);
+        system.setRules(rules);
+        for (int i = 0; i < count; ++i) {
+            system.add(random(width - 0.01f), random(height - 0.01f), random(2.0f) - 1.0f,
+                       random(2.0f) - 1.0f, std::rand() % rules.typeCount, 1.0f + i);
+        }
+
+        long mismatched = 0;
+        for (int tick = 0; tick < 20; ++tick) {
+            std::map<float, Particle> before = byId(system);
+            std::vector<float> ids;
+            std::vector<Particle> state;
+            for (const auto& entry : before) {
+                ids.push_back(entry.first);
+                state.push_back(entry.second);
+            }
+            std::vector<Particle> expected = bruteForceStep(state, rules, width, height);
+
+            system.step();
+            std::map<float, Particle> after = byId(system);
+            for (size_t i = 0; i < ids.size(); ++i) {
+                const Particle& got = after[ids[i]];
+                const Particle& want = expected[i];
+                if (!close(got.x, want.x) || !close(got.y, want.y) ||
+                    !close(got.vx, want.vx) || !close(got.vy, want.vy) || got.type != want.type) {
+                    mismatched++;
+                }
+            }
+        }
+        CHECK_EQ(system.size(), (size_t)count);
+        CHECK_EQ(mismatched, 0);
+    }
+
+    void testWrap() {
+        ParticleRules rules;
+        rules.typeCount = 4;
+        rules.interactionRadius = 40.0f;
+        checkAgainstBruteForce(rules, 400.0f, 300.0f, 400);
+    }
+
+    void testWalls() {
+        ParticleRules rules;
+        rules.typeCount = 3;
+        rules.interactionRadius = 40.0f;
+        rules.wrapEdges = false;
+        rules.wallMargin = 10.0f;
+        rules.maxSpeed = 20.0f;
+        checkAgainstBruteForce(rules, 400.0f, 300.0f, 400);
+    }
+
+    // A radius that does not divide the world gives cells wider than the
+    // radius; a radius close to the world size gives a grid of a few cells
+    // whose wrapped neighbors repeat, or a single cell.
+    void testCoarseGrids() {
+        ParticleRules rules;
+        rules.typeCount = 2;
+        for (float radius : {37.0f, 130.0f, 190.0f, 350.0f}) {
+            rules.interactionRadius = radius;
+            rules.wrapEdges = true;
+            checkAgainstBruteForce(rules, 400.0f, 300.0f, 200);
+            rules.wrapEdges = false;
+            checkAgainstBruteForce(rules, 400.0f, 300.0f, 200);
+        }
+    }
+}
+
+int main() {
+    testWrap();
+    testWalls();
+    testCoarseGrids();
+    return FernTest::finish("particles");
+}
@@ -0,0 +1,118 @@
+#include "fern/graphics/path.hpp"
+#include "test.hpp"
+#include <cmath>
+#include <cstdlib>
+
+using namespace Fern;
+
+namespace {
+    const double PI = 3.14159265358979;
+
+    long drawnPixels(const FernTest::TestCanvas& canvas) {
+        long count = 0;
+        for (uint32_t p : canvas.pixels()) count += p != 0;
+        return count;
+    }
+
+    // Four arcTo corners with radius half the side make a circle.
+    Path circle(float cx, float cy, float r) {
+        Path path;
+        path.moveTo(cx, cy - r)
+            .arcTo(cx + r, cy - r, cx + r, cy, r)
+            .arcTo(cx + r, cy + r, cx, cy + r, r)
+            .arcTo(cx - r, cy + r, cx - r, cy, r)
+            .arcTo(cx - r, cy - r, cx, cy - r, r)
+            .close();
+        return path;
+    }
+
+    void testArcCircle() {
+        FernTest::TestCanvas canvas(400, 400);
+        const float r = 100;
+        circle(200, 200, r).fill(1);
+        // Within a quarter pixel of the circle all around.
+        CHECK(std::fabs(drawnPixels(canvas) - PI * r * r) < 2 * PI * r * 0.25);
+
+        // Every pixel well inside is filled and none well outside.
+        long wrong = 0;
+        for (int y = 0; y < 400; ++y) {
+            for (int x = 0; x < 400; ++x) {
+                double d = std::sqrt((x - 200.0) * (x - 200.0) + (y - 200.0) * (y - 200.0));
+                bool drawn = canvas.at(x, y) != 0;
+                if ((d < r - 0.5 && !drawn) || (d > r + 0.5 && drawn)) wrong++;
+            }
+        }
+        CHECK_EQ(wrong, 0);
+    }
+
+    void testFillRules() {
+        FernTest::TestCanvas canvas(400, 400);
+        Path squares;
+        squares.moveTo(50, 50).lineTo(350, 50).lineTo(350, 350).lineTo(50, 350).close()
+               .moveTo(100, 100).lineTo(300, 100).lineTo(300, 300).lineTo(100, 300).close();
+
+        // Pixel centers on the left and top edges are inside.
+        squares.fill(1, FillRule::NonZero);
+        CHECK_EQ(drawnPixels(canvas), 300L * 300);
+        canvas.clear();
+        squares.fill(1, FillRule::EvenOdd);
+        CHECK_EQ(drawnPixels(canvas), 300L * 300 - 200L * 200);
+        CHECK(canvas.at(200, 200) == 0);
+        CHECK(canvas.at(75, 75) != 0);
+    }
+
+    // Halving the tolerance changes the flattened curve by less than the
+    // tolerance along its length.
+    void testCurveTolerance() {
+        FernTest::TestCanvas canvas(400, 400);
+        Path blob;
+        blob.moveTo(20, 380).cubicTo(20, -100, 380, -100, 380, 380).close();
+        blob.fill(1);
+        long coarse = drawnPixels(canvas);
+        canvas.clear();
+        blob.setTolerance(0.01f);
+        blob.fill(1);
+        long fine = drawnPixels(canvas);
+        CHECK(std::labs(coarse - fine) < 1200 * 0.25);
+
+        canvas.clear();
+        Path quad;
+        quad.moveTo(0, 200).quadTo(200, -200, 400, 200).close();
+        quad.fill(1);
+        // Area under the parabola peaking at y = 0: 2/3 of its bounding box.
+        CHECK(std::fabs(drawnPixels(canvas) - 400.0 * 200 * 2 / 3) < 400);
+    }
+
+    void testStroke() {
+        FernTest::TestCanvas canvas(400, 400);
+        const float r = 100, width = 10;
+        circle(200, 200, r).stroke(width, 1, LineJoin::Round);
+        CHECK(std::fabs(drawnPixels(canvas) - 2 * PI * r * width) < 2 * PI * r);
+
+        // After close(), drawing continues from the closed subpath's start.
+        canvas.clear();
+        Path path;
+        path.moveTo(10, 10).lineTo(100, 10).close().lineTo(10, 100);
+        path.stroke(3, 1);
+        CHECK(canvas.at(10, 50) != 0);
+        CHECK(canvas.at(50, 10) != 0);
+    }
+
+    void testFractionalCoordinates() {
+        FernTest::TestCanvas canvas(40, 40);
+        Path square;
+        square.moveTo(9.6f, 9.6f).lineTo(19.6f, 9.6f).lineTo(19.6f, 19.6f).lineTo(9.6f, 19.6f).close();
+        square.fill(1);
+        CHECK_EQ(drawnPixels(canvas), 100L);
+        CHECK(canvas.at(10, 10) != 0 && canvas.at(19, 19) != 0);
+    }
+}
+
+int main() {
+    testArcCircle();
+    testFillRules();
+    testCurveTolerance();
+    testStroke();
+    testFractionalCoordinates();
+    return FernTest::finish("path");
+}
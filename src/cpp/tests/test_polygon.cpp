@@ -0,0 +1,96 @@
+#include "fern/graphics/primitives.hpp"
+#include "test.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace Fern;
+
+namespace {
+    // Pixel centers are inside by the winding number (non-zero) or the
+    // crossing count (even-odd) of a ray cast to the left.
+    bool inside(const std::vector<Point>& points, int x, int y, FillRule rule) {
+        int winding = 0, crossings = 0;
+        size_t count = points.size();
+        for (size_t i = 0; i < count; ++i) {
+            const Point& a = points[i];
+            const Point& b = points[(i + 1) % count];
+            if ((a.y <= y) == (b.y <= y)) continue;
+            double crossing = a.x + (double)(y - a.y) * (b.x - a.x) / (b.y - a.y);
+            if (crossing <= x) {
+                crossings++;
+                winding += a.y < b.y ? 1 : -1;
+            }
+        }
+        return rule == FillRule::EvenOdd ? (crossings & 1) != 0 : winding != 0;
+    }
+
+    // Random polygons, self-intersecting and partly off the canvas, match
+    // the reference exactly under both rules.
+    void testMatchesReference() {
+        const int W = 320, H = 240;
+        FernTest::TestCanvas canvas(W, H);
+        std::srand(3);
+        long mismatches[2] = {0, 0};
+        for (int trial = 0; trial < 200; ++trial) {
+            std::vector<Point> points;
+            int count = 3 + std::rand() % 12;
+            for (int i = 0; i < count; ++i) {
+                points.push_back(Point(std::rand() % (W + 80) - 40, std::rand() % (H + 80) - 40));
+            }
+            for (int r = 0; r < 2; ++r) {
+                FillRule rule = r ? FillRule::EvenOdd : FillRule::NonZero;
+                canvas.clear();
+                Draw::polygon(points, 1, rule);
+                for (int y = 0; y < H; ++y) {
+                    for (int x = 0; x < W; ++x) {
+                        if (inside(points, x, y, rule) != (canvas.at(x, y) != 0)) mismatches[r]++;
+                    }
+                }
+            }
+        }
+        CHECK_EQ(mismatches[0], 0);
+        CHECK_EQ(mismatches[1], 0);
+    }
+
+    // A star with thousands of vertices, winding several times around.
+    void testLargeStar() {
+        const int W = 320, H = 240;
+        FernTest::TestCanvas canvas(W, H);
+        std::vector<Point> star;
+        for (int i = 0; i < 1000; ++i) {
+            double angle = i * 2.0 * 3.14159265358979 / 1000 * 7;
+            double radius = (i % 2) ? 60 : 110;
+            star.push_back(Point((int)(160 + radius * std::cos(angle)),
+                                 (int)(120 + radius * std::sin(angle))));
+        }
+        for (FillRule rule : {FillRule::NonZero, FillRule::EvenOdd}) {
+            canvas.clear();
+            Draw::polygon(star, 1, rule);
+            long mismatches = 0;
+            for (int y = 0; y < H; ++y) {
+                for (int x = 0; x < W; ++x) {
+                    if (inside(star, x, y, rule) != (canvas.at(x, y) != 0)) mismatches++;
+                }
+            }
+            CHECK_EQ(mismatches, 0);
+        }
+    }
+
+    void testDegenerate() {
+        FernTest::TestCanvas canvas(20, 20);
+        Draw::polygon({}, 1);
+        Draw::polygon({Point(1, 1), Point(10, 10)}, 1);
+        Draw::polygon({Point(1, 1), Point(10, 1), Point(19, 1)}, 1);
+        long drawn = 0;
+        for (uint32_t p : canvas.pixels()) drawn += p != 0;
+        CHECK_EQ(drawn, 0);
+    }
+}
+
+int main() {
+    testMatchesReference();
+    testLargeStar();
+    testDegenerate();
+    return FernTest::finish("polygon");
+}
@@ -0,0 +1,120 @@
+#include "fern/graphics/primitives.hpp"
+#include "test.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace Fern;
+
+namespace {
+    double segmentDistance(double px, double py, const Point& a, const Point& b) {
+        double ex = b.x - a.x, ey = b.y - a.y;
+        double length = ex * ex + ey * ey;
+        double t = length > 0 ? ((px - a.x) * ex + (py - a.y) * ey) / length : 0.0;
+        t = std::max(0.0, std::min(1.0, t));
+        double dx = px - a.x - t * ex, dy = py - a.y - t * ey;
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    // With round joins and caps a stroke is every pixel within half the
+    // width of the path. Pixels within a hair of the boundary may go
+    // either way.
+    void testRoundStrokeMatchesDistance() {
+        FernTest::TestCanvas canvas(300, 200);
+        std::srand(1);
+        long mismatches = 0;
+        for (int trial = 0; trial < 50; ++trial) {
+            canvas.clear();
+            std::vector<Point> points;
+            int count = 2 + std::rand() % 8;
+            for (int i = 0; i < count; ++i) {
+                points.push_back(Point(std::rand() % 300 - 10, std::rand() % 200));
+            }
+            int thickness = 1 + std::rand() % 20;
+            Draw::polyline(points, thickness, LineJoin::Round, LineCap::Round, 0xFFFFFFFF);
+
+            double half = thickness * 0.5;
+            for (int y = 0; y < 200; ++y) {
+                for (int x = 0; x < 300; ++x) {
+                    double best = 1e9;
+                    for (size_t i = 1; i < points.size(); ++i) {
+                        best = std::min(best, segmentDistance(x, y, points[i - 1], points[i]));
+                    }
+                    bool drawn = canvas.at(x, y) != 0;
+                    if ((best < half - 1e-3 && !drawn) || (best > half + 1e-3 && drawn)) {
+                        mismatches++;
+                    }
+                }
+            }
+        }
+        CHECK_EQ(mismatches, 0);
+    }
+
+    // Butt caps end flush; square caps extend half the width.
+    void testCaps() {
+        FernTest::TestCanvas canvas(40, 20);
+        Draw::polyline({Point(10, 10), Point(29, 10)}, 5, LineJoin::Miter, LineCap::Butt, 1);
+        CHECK(canvas.at(11, 10) && canvas.at(28, 10));
+        CHECK(!canvas.at(9, 10) && !canvas.at(30, 10));
+        CHECK(canvas.at(20, 8) && canvas.at(20, 12));
+        CHECK(!canvas.at(20, 7) && !canvas.at(20, 13));
+
+        canvas.clear();
+        Draw::polyline({Point(10, 10), Point(29, 10)}, 5, LineJoin::Miter, LineCap::Square, 1);
+        CHECK(canvas.at(9, 10) && canvas.at(30, 10));
+        CHECK(!canvas.at(7, 10) && !canvas.at(32, 10));
+    }
+
+    // Joins only differ at the outside of the corner: a miter reaches
+    // past a bevel, and a round join sits between them.
+    void testJoins() {
+        FernTest::TestCanvas canvas(60, 60);
+        std::vector<Point> corner{Point(10, 50), Point(30, 10), Point(50, 50)};
+        long area[3];
+        LineJoin joins[3] = {LineJoin::Bevel, LineJoin::Round, LineJoin::Miter};
+        for (int j = 0; j < 3; ++j) {
+            canvas.clear();
+            Draw::polyline(corner, 8, joins[j], LineCap::Butt, 1);
+            area[j] = 0;
+            for (uint32_t p : canvas.pixels()) area[j] += p != 0;
+        }
+        CHECK(area[0] < area[1]);
+        CHECK(area[1] < area[2]);
+    }
+
+    // Overlapping segments are filled once, so a translucent stroke has no
+    // darker crossings.
+    void testSingleCoverage() {
+        FernTest::TestCanvas canvas(100, 100);
+        canvas.canvas().clear(0xFF000000);
+        Draw::polyline({Point(10, 10), Point(90, 90), Point(90, 10), Point(10, 90)}, 9,
+                       LineJoin::Round, LineCap::Round, 0x80FFFFFF);
+        uint32_t first = canvas.at(50, 50);
+        bool uniform = first != 0xFF000000;
+        for (uint32_t p : canvas.pixels()) uniform &= p == 0xFF000000 || p == first;
+        CHECK(uniform);
+    }
+
+    void testDegenerate() {
+        FernTest::TestCanvas canvas(20, 20);
+        Draw::polyline({}, 4, LineJoin::Round, LineCap::Round, 1);
+        Draw::polyline({Point(5, 5)}, 0, LineJoin::Round, LineCap::Round, 1);
+        long drawn = 0;
+        for (uint32_t p : canvas.pixels()) drawn += p != 0;
+        CHECK_EQ(drawn, 0);
+
+        // A single point with a round cap is a dot.
+        Draw::polyline({Point(10, 10)}, 6, LineJoin::Round, LineCap::Round, 1);
+        CHECK(canvas.at(10, 10) != 0);
+    }
+}
+
+int main() {
+    testRoundStrokeMatchesDistance();
+    testCaps();
+    testJoins();
+    testSingleCoverage();
+    testDegenerate();
+    return FernTest::finish("polyline");
+}
@@ -0,0 +1,119 @@
+#include "fern/graphics/progressive.hpp"
+#include "test.hpp"
+#include <atomic>
+#include <memory>
+
+using namespace Fern;
+
+namespace {
+    const int W = 203, H = 77;      // not multiples of any block size
+
+    uint32_t colorAt(int x, int y) {
+        return 0xFF000000u | (uint32_t)(x * 131 + y * 7);
+    }
+
+    // Counts how often each canvas pixel is evaluated.
+    struct CountingShader {
+        std::unique_ptr<std::atomic<int>[]> counts{new std::atomic<int>[W * H]};
+
+        CountingShader() { reset(); }
+        void reset() {
+            for (int i = 0; i < W * H; ++i) counts[i].store(0);
+        }
+        uint32_t operator()(int x, int y) {
+            counts[y * W + x]++;
+            return colorAt(x, y);
+        }
+        // Every pixel of area evaluated once, and nothing outside it.
+        bool exactlyOnce(const Rect& area) const {
+            for (int y = 0; y < H; ++y) {
+                for (int x = 0; x < W; ++x) {
+                    if (counts[y * W + x].load() != (area.contains(x, y) ? 1 : 0)) return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    // With no time budget each call advances a single band, so the run is
+    // spread over many frames; together the passes evaluate every pixel
+    // exactly once and leave each with its own value.
+    void testPassesCoverOnce() {
+        FernTest::TestCanvas canvas(W, H);
+        const Rect areas[] = {Rect(0, 0, W, H), Rect(5, 3, 150, 61), Rect(-10, 40, 100, 100)};
+        const Rect clipped[] = {Rect(0, 0, W, H), Rect(5, 3, 150, 61), Rect(0, 40, 90, 37)};
+        for (int a = 0; a < 3; ++a) {
+            CountingShader shader;
+            ProgressiveRenderer renderer(8, 0.0);
+            int calls = 0;
+            bool coarseFilled = false;
+            while (!renderer.render(areas[a], [&](int x, int y) { return shader(x, y); })) {
+                calls++;
+                if (renderer.getBlockSize() == 4 && !coarseFilled) {
+                    // The coarse pass has just finished: every pixel shows
+                    // the sample of its block.
+                    coarseFilled = true;
+                    bool filled = true;
+                    const Rect& r = clipped[a];
+                    for (int y = r.y; y < r.y + r.height; ++y) {
+                        for (int x = r.x; x < r.x + r.width; ++x) {
+                            int sx = r.x + (x - r.x) / 8 * 8, sy = r.y + (y - r.y) / 8 * 8;
+                            filled &= canvas.at(x, y) == colorAt(sx, sy);
+                        }
+                    }
+                    CHECK(filled);
+                }
+            }
+            CHECK(calls > 4);
+            CHECK(coarseFilled);
+            CHECK(shader.exactlyOnce(clipped[a]));
+
+            bool exact = true;
+            for (int y = 0; y < H; ++y) {
+                for (int x = 0; x < W; ++x) {
+                    if (clipped[a].contains(x, y)) exact &= canvas.at(x, y) == colorAt(x, y);
+                }
+            }
+            CHECK(exact);
+
+            // A finished run evaluates nothing more.
+            shader.reset();
+            CHECK(renderer.render(areas[a], [&](int x, int y) { return shader(x, y); }));
+            CHECK(shader.exactlyOnce(Rect()));
+            canvas.clear();
+        }
+    }
+
+    // invalidate() in the middle of a run, and after it, restarts from the
+    // coarse pass and evaluates every pixel again exactly once.
+    void testInvalidateRestarts() {
+        FernTest::TestCanvas canvas(W, H);
+        Rect area(0, 0, W, H);
+        CountingShader shader;
+        ProgressiveRenderer renderer(8, 0.0);
+        auto fn = [&](int x, int y) { return shader(x, y); };
+
+        renderer.render(area, fn);
+        renderer.render(area, fn);
+        while (renderer.getBlockSize() == 8) renderer.render(area, fn);
+        CHECK(!renderer.isComplete());
+
+        renderer.invalidate();
+        CHECK_EQ(renderer.getBlockSize(), 8);
+        shader.reset();
+        while (!renderer.render(area, fn)) {}
+        CHECK(shader.exactlyOnce(area));
+
+        renderer.invalidate();
+        CHECK(!renderer.isComplete());
+        shader.reset();
+        while (!renderer.render(area, fn)) {}
+        CHECK(shader.exactlyOnce(area));
+    }
+}
+
+int main() {
+    testPassesCoverOnce();
+    testInvalidateRestarts();
+    return FernTest::finish("progressive");
+}
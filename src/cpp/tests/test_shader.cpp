@@ -0,0 +1,80 @@
+#include "fern/graphics/shader.hpp"
+#include "test.hpp"
+#include <cstdint>
+
+using namespace Fern;
+
+namespace {
+    const int W = 301, H = 77;      // neither is a multiple of the tile size
+    const uint32_t BACKGROUND = 0;
+
+    uint32_t pattern(int x, int y) {
+        return 0xFF000000u | (uint32_t)(x * 7919 + y * 104729);
+    }
+
+    // Every pixel of the clipped area holds pattern(x, y); everything else
+    // is untouched.
+    long mismatches(FernTest::TestCanvas& canvas, const Rect& area) {
+        long wrong = 0;
+        for (int y = 0; y < H; ++y) {
+            for (int x = 0; x < W; ++x) {
+                uint32_t expected = area.contains(x, y) ? pattern(x, y) : BACKGROUND;
+                if (canvas.at(x, y) != expected) wrong++;
+            }
+        }
+        return wrong;
+    }
+
+    const Rect AREAS[] = {
+        Rect(0, 0, W, H),
+        Rect(3, 5, 130, 40),            // tile edge mid-area
+        Rect(-20, -10, 70, 30),         // off the top left
+        Rect(W - 45, H - 20, 90, 60),   // off the bottom right
+        Rect(-5, -5, W + 10, H + 10),   // covers the canvas
+        Rect(W + 5, 0, 10, 10),         // entirely off
+        Rect(10, 10, 0, 5),             // empty
+    };
+
+    void testShadeClips() {
+        FernTest::TestCanvas canvas(W, H);
+        long wrong = 0;
+        for (const Rect& area : AREAS) {
+            canvas.clear();
+            Draw::shade(area, [](int x, int y) { return pattern(x, y); });
+            wrong += mismatches(canvas, area);
+        }
+        CHECK_EQ(wrong, 0);
+    }
+
+    // Widths that leave one to Lanes - 1 pixels over at the right edge of a
+    // tile go through the scratch path and must not write past it.
+    template <int Lanes>
+    void checkLanes(FernTest::TestCanvas& canvas, long& wrong) {
+        for (const Rect& area : AREAS) {
+            for (int extra = 0; extra < Lanes; ++extra) {
+                Rect narrowed(area.x, area.y, area.width > extra ? area.width - extra : 0, area.height);
+                canvas.clear();
+                Draw::shadeLanes<Lanes>(narrowed, [](int x, int y, uint32_t* out) {
+                    for (int i = 0; i < Lanes; ++i) out[i] = pattern(x + i, y);
+                });
+                wrong += mismatches(canvas, narrowed);
+            }
+        }
+    }
+
+    void testShadeLanesTail() {
+        FernTest::TestCanvas canvas(W, H);
+        long wrong = 0;
+        checkLanes<1>(canvas, wrong);
+        checkLanes<3>(canvas, wrong);
+        checkLanes<4>(canvas, wrong);
+        checkLanes<8>(canvas, wrong);
+        CHECK_EQ(wrong, 0);
+    }
+}
+
+int main() {
+    testShadeClips();
+    testShadeLanesTail();
+    return FernTest::finish("shader");
+}
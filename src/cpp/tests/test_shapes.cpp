@@ -0,0 +1,138 @@
+#include "fern/graphics/primitives.hpp"
+#include "test.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace Fern;
+
+namespace {
+    const int W = 300, H = 200;
+
+    // Span-based circles, ellipses and rounded rectangles against a direct
+    // inside test for every pixel.
+    void testShapesMatchReference() {
+        FernTest::TestCanvas canvas(W, H);
+        std::srand(5);
+        long ellipses = 0, circles = 0, rounded = 0;
+        for (int trial = 0; trial < 300; ++trial) {
+            int cx = std::rand() % W, cy = std::rand() % H;
+            int rx = std::rand() % 120, ry = std::rand() % 120;
+            canvas.clear();
+            Draw::ellipse(cx, cy, rx, ry, 1);
+            for (int y = 0; y < H; ++y) {
+                for (int x = 0; x < W; ++x) {
+                    int64_t dx = x - cx, dy = y - cy;
+                    bool in;
+                    if (dy * dy > (int64_t)ry * ry) {
+                        in = false;
+                    } else if (ry == 0) {
+                        in = dy == 0 && dx * dx <= (int64_t)rx * rx;
+                    } else {
+                        in = (int64_t)ry * ry * dx * dx + (int64_t)rx * rx * dy * dy <=
+                             (int64_t)rx * rx * ry * ry;
+                    }
+                    if (in != (canvas.at(x, y) != 0)) ellipses++;
+                }
+            }
+
+            int r = std::rand() % 60;
+            canvas.clear();
+            Draw::circle(cx, cy, r, 1);
+            for (int y = 0; y < H; ++y) {
+                for (int x = 0; x < W; ++x) {
+                    int64_t dx = x - cx, dy = y - cy;
+                    if ((dx * dx + dy * dy <= (int64_t)r * r) != (canvas.at(x, y) != 0)) circles++;
+                }
+            }
+
+            int left = std::rand() % W - 20, top = std::rand() % H - 20;
+            int w = std::rand() % 150, h = std::rand() % 150, radius = std::rand() % 60;
+            canvas.clear();
+            Draw::roundedRect(left, top, w, h, radius, 1);
+            int rr = std::min(radius, std::min(w, h) / 2);
+            for (int y = 0; y < H; ++y) {
+                for (int x = 0; x < W; ++x) {
+                    bool in = x >= left && x < left + w && y >= top && y < top + h;
+                    if (in && rr > 0) {
+                        // Distance to the nearest corner circle's center.
+                        int ccx = x < left + rr ? left + rr : (x > left + w - 1 - rr ? left + w - 1 - rr : x);
+                        int ccy = y < top + rr ? top + rr : (y > top + h - 1 - rr ? top + h - 1 - rr : y);
+                        int64_t dx = x - ccx, dy = y - ccy;
+                        in = dx * dx + dy * dy <= (int64_t)rr * rr;
+                    }
+                    if (in != (canvas.at(x, y) != 0)) rounded++;
+                }
+            }
+        }
+        CHECK_EQ(ellipses, 0);
+        CHECK_EQ(circles, 0);
+        CHECK_EQ(rounded, 0);
+    }
+
+    // Batched circles and rects are drawn in parallel bands but must match
+    // drawing them one by one, overlaps included.
+    void testBatchesMatchSerial() {
+        FernTest::TestCanvas canvas(W, H);
+        std::srand(8);
+        std::vector<Point> centers;
+        std::vector<int> radii;
+        std::vector<Rect> rects;
+        std::vector<uint32_t> colors;
+        for (int i = 0; i < 3000; ++i) {
+            centers.push_back(Point(std::rand() % W, std::rand() % H));
+            radii.push_back(std::rand() % 12);
+            rects.push_back(Rect(std::rand() % W - 5, std::rand() % H - 5, std::rand() % 20, std::rand() % 20));
+            colors.push_back(0xFF000000 | (uint32_t)std::rand());
+        }
+
+        Draw::circles(centers, radii, colors);
+        Draw::rects(rects, colors);
+        std::vector<uint32_t> batched = canvas.pixels();
+
+        canvas.clear();
+        for (size_t i = 0; i < centers.size(); ++i) Draw::circle(centers[i].x, centers[i].y, radii[i], colors[i]);
+        for (size_t i = 0; i < rects.size(); ++i) {
+            Draw::rect(rects[i].x, rects[i].y, rects[i].width, rects[i].height, colors[i]);
+        }
+        CHECK(batched == canvas.pixels());
+    }
+
+    // Brushes drawn from several threads at once, each into its own band,
+    // with radii that keep building and evicting cached stamps.
+    void testConcurrentStamps() {
+        const int BANDS = 4, BAND_HEIGHT = 400;
+        FernTest::TestCanvas canvas(800, BANDS * BAND_HEIGHT);
+        auto drawBand = [](int band) {
+            int top = band * BAND_HEIGHT;
+            for (int i = 0; i < 60; ++i) {
+                int radius = (i * 37 + band * 11) % 190;
+                int cx = 200 + (i * 53) % 400, cy = top + BAND_HEIGHT / 2;
+                int clipped = std::min(radius, BAND_HEIGHT / 2 - 1);
+                uint32_t color = 0xFF000000 | (uint32_t)(i * 7919 + band);
+                Draw::stamp(cx, cy, clipped, color, i % 2 == 0);
+                Draw::circle(cx, cy, clipped / 2, color ^ 0xFFFFFF);
+                Draw::line(cx - 100, cy, cx + 100, cy, i % 9, color);
+            }
+        };
+
+        // Threads first, while the cache is cold.
+        std::vector<std::thread> threads;
+        for (int band = 0; band < BANDS; ++band) threads.emplace_back(drawBand, band);
+        for (std::thread& thread : threads) thread.join();
+        std::vector<uint32_t> concurrent = canvas.pixels();
+
+        canvas.clear();
+        for (int band = 0; band < BANDS; ++band) drawBand(band);
+        CHECK(concurrent == canvas.pixels());
+    }
+}
+
+int main() {
+    testShapesMatchReference();
+    testBatchesMatchSerial();
+    testConcurrentStamps();
+    return FernTest::finish("shapes");
+}
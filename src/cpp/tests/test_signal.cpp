@@ -0,0 +1,154 @@
+#include "fern/core/signal.hpp"
+#include "test.hpp"
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace Fern;
+
+namespace {
+    struct Counted {
+        static int copies;
+        Counted() = default;
+        Counted(const Counted&) { copies++; }
+    };
+    int Counted::copies = 0;
+
+    void testConnectDisconnect() {
+        Signal<int> signal;
+        int sum = 0;
+        std::vector<Signal<int>::ConnectionID> ids;
+        for (int i = 0; i < 10; ++i) {
+            ids.push_back(signal.connect([&sum, i](int v) { sum += v * i; }));
+        }
+        signal.emit(1);
+        CHECK_EQ(sum, 45);
+
+        signal.disconnect(ids[3]);
+        signal.disconnect(ids[3]);
+        sum = 0;
+        signal.emit(1);
+        CHECK_EQ(sum, 42);
+
+        // The freed slot is reused; the old ID must not remove the new slot.
+        signal.connect([&sum](int) { sum += 1000; });
+        signal.disconnect(ids[3]);
+        sum = 0;
+        signal.emit(0);
+        CHECK_EQ(sum, 1000);
+    }
+
+    // IDs do not convert to integers, so they can't be truncated when
+    // size_t is 32 bits.
+    static_assert(!std::is_convertible<ConnectionID, uint64_t>::value, "ConnectionID must not narrow");
+    static_assert(!std::is_convertible<ConnectionID, size_t>::value, "ConnectionID must not narrow");
+
+    void testConnectionIDs() {
+        Signal<> signal;
+        int calls = 0;
+        ConnectionID none;
+        signal.disconnect(none);
+        ConnectionID first = signal.connect([&] { calls++; });
+        ConnectionID second = signal.connect([&] { calls++; });
+        CHECK(first != second);
+        CHECK(first != none);
+        signal.disconnect(none);
+        signal.emit();
+        CHECK_EQ(calls, 2);
+
+        // Same slot, new generation: a different ID.
+        signal.disconnect(first);
+        ConnectionID reused = signal.connect([&] { calls += 10; });
+        CHECK(reused != first);
+        calls = 0;
+        signal.emit();
+        CHECK_EQ(calls, 11);
+    }
+
+    void testChangesDuringEmit() {
+        Signal<> signal;
+        Signal<>::ConnectionID self;
+        int calls = 0;
+        self = signal.connect([&] {
+            calls++;
+            signal.disconnect(self);
+            signal.connect([&] { calls += 100; });
+        });
+        signal.emit();
+        CHECK_EQ(calls, 1);
+        signal.emit();
+        CHECK_EQ(calls, 101);
+
+        Signal<int> nested;
+        int depth = 0;
+        nested.connect([&](int d) {
+            depth++;
+            if (d < 3) nested.emit(d + 1);
+        });
+        nested.emit(0);
+        CHECK_EQ(depth, 4);
+    }
+
+    void testSlotStorage() {
+        // Too big for inline storage, so it lives on the heap.
+        std::string big(100, 'x');
+        auto shared = std::make_shared<int>(5);
+        std::string got;
+        Signal<const std::string&> signal;
+        signal.connect([big, shared, &got](const std::string& v) {
+            got = v + big.substr(0, 1) + std::to_string(*shared);
+        });
+        signal.emit("a");
+        CHECK_EQ(got, std::string("ax5"));
+
+        Signal<const std::string&> copy = signal;
+        copy.emit("b");
+        CHECK_EQ(got, std::string("bx5"));
+
+        Signal<> fromFunction;
+        int called = 0;
+        std::function<void()> fn = [&] { called++; };
+        fromFunction.connect(fn);
+        fromFunction.emit();
+        CHECK_EQ(called, 1);
+    }
+
+    void testArguments() {
+        Signal<Counted> byValue;
+        byValue.connect([](const Counted&) {});
+        byValue.connect([](const Counted&) {});
+        Counted counted;
+        byValue.emit(counted);
+        CHECK_EQ(Counted::copies, 0);
+
+        Signal<int&> byReference;
+        byReference.connect([](int& x) { x++; });
+        byReference.connect([](int& x) { x++; });
+        int x = 0;
+        byReference.emit(x);
+        CHECK_EQ(x, 2);
+
+        // Move-only values reach every slot by const reference, and post()
+        // moves them into the queue.
+        Signal<std::unique_ptr<int>> moveOnly;
+        int total = 0;
+        moveOnly.connect([&](const std::unique_ptr<int>& p) { total += *p; });
+        moveOnly.connect([&](const std::unique_ptr<int>& p) { total += *p; });
+        moveOnly.emit(std::unique_ptr<int>(new int(3)));
+        CHECK_EQ(total, 6);
+        CHECK(moveOnly.post(std::unique_ptr<int>(new int(5))));
+        SignalQueue::dispatch();
+        CHECK_EQ(total, 16);
+    }
+}
+
+int main() {
+    testConnectDisconnect();
+    testConnectionIDs();
+    testChangesDuringEmit();
+    testSlotStorage();
+    testArguments();
+    return FernTest::finish("signal");
+}
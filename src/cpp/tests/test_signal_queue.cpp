@@ -0,0 +1,157 @@
+#include "fern/core/signal.hpp"
+#include "test.hpp"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Fern;
+
+namespace {
+    // Several threads post while the test thread dispatches: every emission
+    // is delivered exactly once, with its arguments intact.
+    void testConcurrentPosts() {
+        const int THREADS = 4;
+        const int POSTS = 20000;
+        Signal<int, std::string> signal;
+        long long sum = 0;
+        int count = 0;
+        bool intact = true;
+        signal.connect([&](int v, const std::string& text) {
+            sum += v;
+            count++;
+            intact &= text == "posted";
+        });
+
+        std::atomic<int> finished{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 1; i <= POSTS; ++i) {
+                    while (!signal.post(i, "posted")) std::this_thread::yield();
+                }
+                finished++;
+            });
+        }
+        while (finished.load() < THREADS) {
+            if (SignalQueue::dispatch() == 0) std::this_thread::yield();
+        }
+        for (std::thread& thread : threads) thread.join();
+        SignalQueue::dispatch();
+
+        CHECK_EQ(count, THREADS * POSTS);
+        CHECK_EQ(sum, (long long)THREADS * POSTS * (POSTS + 1) / 2);
+        CHECK(intact);
+    }
+
+    void testOrderAndCoalescing() {
+        Signal<int> ordered;
+        std::vector<int> seen;
+        ordered.connect([&](int v) { seen.push_back(v); });
+        for (int i = 0; i < 10; ++i) ordered.post(i);
+        CHECK_EQ(SignalQueue::dispatch(), 10u);
+        bool inOrder = seen.size() == 10;
+        for (size_t i = 0; i < seen.size(); ++i) inOrder &= seen[i] == (int)i;
+        CHECK(inOrder);
+
+        Signal<int> latest;
+        latest.setCoalescing(true);
+        latest.reservePosts(100);
+        int last = -1, calls = 0;
+        latest.connect([&](int v) { last = v; calls++; });
+        for (int i = 0; i < 100; ++i) latest.post(i);
+        SignalQueue::dispatch();
+        CHECK_EQ(calls, 1);
+        CHECK_EQ(last, 99);
+    }
+
+    // A coalescing signal reuses its one pending emission, so however many
+    // posts a frame sees, the pool does not run out and the value delivered
+    // is the newest one.
+    void testCoalescingKeepsLatest() {
+        Signal<int> latest;
+        latest.setCoalescing(true);
+        latest.reservePosts(2);
+        int last = -1, calls = 0;
+        latest.connect([&](int v) { last = v; calls++; });
+        bool accepted = true;
+        for (int frame = 0; frame < 3; ++frame) {
+            for (int i = 0; i < 1000; ++i) accepted &= latest.post(frame * 1000 + i);
+            CHECK_EQ(SignalQueue::dispatch(), 1u);
+            CHECK_EQ(last, frame * 1000 + 999);
+        }
+        CHECK(accepted);
+        CHECK_EQ(calls, 3);
+        CHECK_EQ(SignalQueue::dispatch(), 0u);
+
+        // Several posting threads: the value delivered last is the final
+        // post of one of them.
+        const int THREADS = 4, POSTS = 20000;
+        std::atomic<int> finished{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 1; i <= POSTS; ++i) {
+                    while (!latest.post(t * POSTS + i)) std::this_thread::yield();
+                }
+                finished++;
+            });
+        }
+        while (finished.load() < THREADS) {
+            if (SignalQueue::dispatch() == 0) std::this_thread::yield();
+        }
+        for (std::thread& thread : threads) thread.join();
+        SignalQueue::dispatch();
+        bool final = false;
+        for (int t = 0; t < THREADS; ++t) final |= last == (t + 1) * POSTS;
+        CHECK(final);
+
+        // Dropped with its signal, the pending emission is still destroyed.
+        auto value = std::make_shared<int>(7);
+        {
+            Signal<std::shared_ptr<int>> dropped;
+            dropped.setCoalescing(true);
+            dropped.post(value);
+            dropped.post(value);
+            CHECK_EQ(value.use_count(), 2);
+        }
+        CHECK_EQ(SignalQueue::dispatch(), 0u);
+        CHECK_EQ(value.use_count(), 1);
+    }
+
+    // Posting takes emissions from a fixed pool; a full pool refuses
+    // posts until the render thread delivers and recycles them.
+    void testPoolExhaustion() {
+        Signal<std::string> signal;
+        signal.reservePosts(4);
+        int delivered = 0;
+        signal.connect([&](const std::string&) { delivered++; });
+        for (int round = 0; round < 3; ++round) {
+            for (int i = 0; i < 4; ++i) CHECK(signal.post("queued"));
+            CHECK(!signal.post("dropped"));
+            CHECK_EQ(SignalQueue::dispatch(), 4u);
+        }
+        CHECK_EQ(delivered, 12);
+    }
+
+    void testDestroyedSignal() {
+        bool delivered = false;
+        {
+            Signal<int> signal;
+            signal.connect([&](int) { delivered = true; });
+            signal.post(1);
+        }
+        CHECK_EQ(SignalQueue::dispatch(), 0u);
+        CHECK(!delivered);
+    }
+}
+
+int main() {
+    testConcurrentPosts();
+    testOrderAndCoalescing();
+    testCoalescingKeepsLatest();
+    testPoolExhaustion();
+    testDestroyedSignal();
+    return FernTest::finish("signal_queue");
+}
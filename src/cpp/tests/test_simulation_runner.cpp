@@ -0,0 +1,137 @@
+// The inline path, as in browser builds without -pthread: steps run inside
+// acquire(), so the test decides when they can happen.
+#define FERN_THREADS 0
+
+#include "fern/core/simulation_runner.hpp"
+#include "test.hpp"
+#include <chrono>
+#include <thread>
+
+using namespace Fern;
+
+namespace {
+    const double STEP = 0.002;
+
+    struct World {
+        uint64_t steps = 0;
+        long tag = 0;               // set by edits
+        uint64_t taggedAt = 0;      // steps of the state the edits landed in
+    };
+
+    void wait(double seconds) {
+        std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    }
+
+    // Copies the state forward and counts steps; flags any aliasing.
+    SimulationRunner<World>::StepFunction counter(bool& aliased) {
+        return [&aliased](const World& current, World& next, double) {
+            aliased |= &current == &next;
+            next = current;
+            next.steps = current.steps + 1;
+        };
+    }
+
+    void stepAtLeastOnce(SimulationRunner<World>& runner) {
+        uint64_t start = runner.getStepCount();
+        while (runner.getStepCount() == start) {
+            wait(STEP);
+            runner.acquire();
+        }
+    }
+
+    // Each acquire() that finds a new state makes it current() and moves the
+    // old current state to previous(); the step count follows the states.
+    void testHandOff() {
+        bool aliased = false;
+        SimulationRunner<World> runner(World(), counter(aliased), STEP);
+        runner.acquire();
+        CHECK_EQ(runner.getStepCount(), 0u);
+        CHECK_EQ(runner.getAlpha(), 1.0f);
+
+        runner.start();
+        int handOffs = 0;
+        bool consistent = true;
+        for (int frame = 0; frame < 50; ++frame) {
+            uint64_t before = runner.current().steps;
+            wait(STEP * 1.5);
+            runner.acquire();
+            const World& current = runner.current();
+            consistent &= current.steps == runner.getStepCount();
+            consistent &= current.steps >= before;
+            if (current.steps > before) {
+                consistent &= runner.previous().steps == before;
+                handOffs++;
+            }
+            float alpha = runner.getAlpha();
+            consistent &= alpha >= 0.0f && alpha <= 1.0f;
+        }
+        CHECK(consistent);
+        CHECK(handOffs > 10);
+        CHECK(!aliased);
+
+        // A stall does not turn into a burst of catch-up steps.
+        uint64_t before = runner.getStepCount();
+        wait(STEP * 40);
+        runner.acquire();
+        CHECK(runner.getStepCount() - before <= 5u);
+
+        runner.setPaused(true);
+        runner.acquire();
+        before = runner.getStepCount();
+        wait(STEP * 5);
+        runner.acquire();
+        CHECK_EQ(runner.getStepCount(), before);
+        runner.stop();
+    }
+
+    struct Copies {
+        static int count;
+        Copies() = default;
+        Copies(const Copies&) { count++; }
+        Copies(Copies&&) = default;
+        Copies& operator=(const Copies&) { count++; return *this; }
+        Copies& operator=(Copies&&) = default;
+    };
+    int Copies::count = 0;
+
+    // Edits land in the next state produced, in the order queued, and are
+    // moved rather than copied on the way.
+    void testModify() {
+        bool aliased = false;
+        SimulationRunner<World> runner(World(), counter(aliased), STEP);
+        runner.start();
+        stepAtLeastOnce(runner);
+
+        Copies tracker;
+        SimulationRunner<World>::EditFunction first = [tracker](World& world) {
+            world.tag = world.tag * 10 + 1;
+            world.taggedAt = world.steps;
+        };
+        Copies::count = 0;
+        uint64_t queuedAt = runner.getStepCount();
+        CHECK(runner.modify(std::move(first)));
+        CHECK(runner.modify([](World& world) { world.tag = world.tag * 10 + 2; }));
+        CHECK_EQ(Copies::count, 0);
+
+        stepAtLeastOnce(runner);
+        CHECK_EQ(runner.current().tag, 12);
+        CHECK_EQ(runner.current().taggedAt, queuedAt + 1);
+        CHECK_EQ(Copies::count, 0);
+        runner.stop();
+    }
+
+    void testEditQueueLimit() {
+        bool aliased = false;
+        SimulationRunner<World> runner(World(), counter(aliased), STEP);
+        int accepted = 0;
+        for (int i = 0; i < 100; ++i) accepted += runner.modify([](World&) {});
+        CHECK_EQ(accepted, 64);
+    }
+}
+
+int main() {
+    testHandOff();
+    testModify();
+    testEditQueueLimit();
+    return FernTest::finish("simulation_runner");
+}
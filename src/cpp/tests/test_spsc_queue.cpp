@@ -0,0 +1,65 @@
+#include "fern/core/spsc_queue.hpp"
+#include "test.hpp"
+#include <cstdint>
+#include <thread>
+
+using namespace Fern;
+
+namespace {
+    void testSingleThread() {
+        SpscQueue<int, 4> queue;
+        int value = 0;
+        CHECK(queue.empty());
+        CHECK(!queue.pop(value));
+        for (int i = 0; i < 4; ++i) CHECK(queue.push(i));
+        CHECK(!queue.push(4));
+        CHECK(queue.pop(value));
+        CHECK_EQ(value, 0);
+        CHECK(queue.push(4));
+
+        int expected = 1;
+        size_t drained = queue.drain([&](int v) { CHECK_EQ(v, expected); expected++; });
+        CHECK_EQ(drained, 4u);
+        CHECK(queue.empty());
+    }
+
+    // A producer and a consumer running flat out: every value arrives once,
+    // in order, whether it is popped singly or in drained batches.
+    void testStress() {
+        const uint32_t COUNT = 200000;
+        static SpscQueue<uint32_t, 256> queue;
+
+        std::thread producer([] {
+            for (uint32_t i = 0; i < COUNT;) {
+                if (queue.push(i)) {
+                    ++i;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        uint32_t next = 0;
+        bool ordered = true;
+        while (next < COUNT) {
+            uint32_t value;
+            if (next % 3 == 0) {
+                queue.drain([&](uint32_t v) { ordered &= v == next++; });
+            } else if (queue.pop(value)) {
+                ordered &= value == next++;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+
+        CHECK(ordered);
+        CHECK(queue.empty());
+    }
+}
+
+int main() {
+    testSingleThread();
+    testStress();
+    return FernTest::finish("spsc_queue");
+}
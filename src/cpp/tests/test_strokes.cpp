@@ -0,0 +1,156 @@
+#include "fern/graphics/strokes.hpp"
+#include "test.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace Fern;
+
+namespace {
+    float distanceToSegment(const Point& p, const Point& a, const Point& b) {
+        double abx = b.x - a.x, aby = b.y - a.y;
+        double apx = p.x - a.x, apy = p.y - a.y;
+        double length = abx * abx + aby * aby;
+        double t = length > 0.0 ? std::min(std::max((apx * abx + apy * aby) / length, 0.0), 1.0) : 0.0;
+        return (float)std::hypot(apx - t * abx, apy - t * aby);
+    }
+
+    float distanceToPolyline(const Point& p, const std::vector<Point>& line) {
+        if (line.size() == 1) return distanceToSegment(p, line[0], line[0]);
+        float nearest = INFINITY;
+        for (size_t i = 1; i < line.size(); ++i) {
+            nearest = std::min(nearest, distanceToSegment(p, line[i - 1], line[i]));
+        }
+        return nearest;
+    }
+
+    // A wobbly random walk, long enough to span several simplification
+    // windows; every input point stays within tolerance of what is kept.
+    void testWithinTolerance() {
+        std::srand(5);
+        for (float tolerance : {0.5f, 1.0f, 3.0f}) {
+            StrokeRecorder recorder(tolerance);
+            std::vector<Point> input{Point(200, 200)};
+            recorder.begin(200, 200, 2, 0xFFFFFFFF);
+            double angle = 0.0;
+            for (int i = 0; i < 1000; ++i) {
+                angle += (std::rand() % 100 - 50) / 200.0;
+                Point next(input.back().x + (int)std::lround(3.0 * std::cos(angle)),
+                           input.back().y + (int)std::lround(3.0 * std::sin(angle)));
+                recorder.addPoint(next.x, next.y);
+                input.push_back(next);
+            }
+            recorder.end();
+
+            std::vector<Point> kept;
+            recorder.getPoints(0, kept);
+            CHECK(kept.size() < input.size() / 2);
+            CHECK_EQ(kept.front().x, input.front().x);
+            CHECK_EQ(kept.back().x, input.back().x);
+            CHECK_EQ(kept.back().y, input.back().y);
+
+            float worst = 0.0f;
+            for (const Point& point : input) worst = std::max(worst, distanceToPolyline(point, kept));
+            CHECK(worst <= tolerance + 1e-3f);
+
+            Rect bounds = recorder.getBounds(0);
+            bool covered = true;
+            for (const Point& point : input) {
+                covered &= point.x - 2 >= bounds.x && point.x + 2 < bounds.x + bounds.width;
+                covered &= point.y - 2 >= bounds.y && point.y + 2 < bounds.y + bounds.height;
+            }
+            CHECK(covered);
+        }
+
+        // A straight line keeps little more than one point per window.
+        StrokeRecorder recorder;
+        recorder.begin(0, 0, 1, 0xFFFFFFFF);
+        for (int i = 1; i <= 300; ++i) recorder.addPoint(i, i / 2);
+        recorder.end();
+        std::vector<Point> kept;
+        recorder.getPoints(0, kept);
+        CHECK(kept.size() <= 1 + 300 / 63 + 1);
+    }
+
+    // Deltas of every encoded length, either sign, up to the full int range,
+    // read back exactly. Each is its own two-point stroke, so both points are
+    // kept whatever the tolerance.
+    void testLargeDeltas() {
+        const int deltas[] = {1, -1, 63, -64, 64, -65, 8191, -8192, 8192, -8193,
+                              1 << 20, -(1 << 20), (1 << 28) + 7, -(1 << 28) - 7,
+                              INT_MAX - 1, -(INT_MAX - 1)};
+        StrokeRecorder recorder;
+        std::vector<Point> expected;
+        for (int dx : deltas) {
+            for (int dy : {0, -dx / 3, dx}) {
+                Point start(dx > 0 ? 0 : -1, dy > 0 ? 0 : -1);
+                Point end(start.x + dx, start.y + dy);
+                recorder.begin(start.x, start.y, 0, 0xFFFFFFFF);
+                recorder.addPoint(end.x, end.y);
+                recorder.end();
+                expected.push_back(start);
+                expected.push_back(end);
+            }
+        }
+
+        bool exact = true;
+        std::vector<Point> points;
+        for (size_t i = 0; i < recorder.size(); ++i) {
+            recorder.getPoints(i, points);
+            exact &= points.size() == 2;
+            if (points.size() != 2) continue;
+            exact &= points[0].x == expected[2 * i].x && points[0].y == expected[2 * i].y;
+            exact &= points[1].x == expected[2 * i + 1].x && points[1].y == expected[2 * i + 1].y;
+        }
+        CHECK_EQ(recorder.size(), expected.size() / 2);
+        CHECK(exact);
+    }
+
+    // Three strokes crossing at (50, 50), oldest first.
+    void testHitTopmost() {
+        StrokeRecorder recorder;
+        recorder.begin(0, 50, 2, 0xFFFF0000);
+        recorder.addPoint(100, 50);
+        recorder.end();
+        recorder.begin(50, 0, 2, 0xFF00FF00);
+        recorder.addPoint(50, 100);
+        recorder.end();
+        recorder.begin(0, 0, 2, 0xFF0000FF);
+        recorder.addPoint(100, 100);
+        recorder.end();
+
+        CHECK_EQ(recorder.hitTest(50, 50), 2);
+        CHECK_EQ(recorder.hitTest(20, 50), 0);
+        CHECK_EQ(recorder.hitTest(50, 80), 1);
+        CHECK_EQ(recorder.hitTest(10, 12), 2);
+
+        // Inside the top stroke's bounds but off its line.
+        CHECK_EQ(recorder.hitTest(80, 52), 0);
+        CHECK_EQ(recorder.hitTest(80, 20), -1);
+
+        // Reach is the brush radius plus slop.
+        CHECK_EQ(recorder.hitTest(20, 52), 0);
+        CHECK_EQ(recorder.hitTest(20, 53), -1);
+        CHECK_EQ(recorder.hitTest(20, 54, 2), 0);
+
+        recorder.removeLast();
+        CHECK_EQ(recorder.hitTest(50, 50), 1);
+        recorder.removeLast();
+        CHECK_EQ(recorder.hitTest(50, 50), 0);
+
+        // A single-point stroke is a dot.
+        recorder.begin(150, 150, 3, 0xFFFFFFFF);
+        recorder.end();
+        CHECK_EQ(recorder.hitTest(152, 152), 1);
+        CHECK_EQ(recorder.hitTest(153, 153), -1);
+    }
+}
+
+int main() {
+    testWithinTolerance();
+    testLargeDeltas();
+    testHitTopmost();
+    return FernTest::finish("strokes");
+}
@@ -0,0 +1,32 @@
+#include "fern/text/font.hpp"
+#include "test.hpp"
+
+using namespace Fern;
+
+namespace {
+    // Smooth glyphs come out the same whether their mask is cached, was
+    // evicted and rebuilt, or is too large to cache at all.
+    void testSmoothGlyphsAfterEviction() {
+        FernTest::TestCanvas canvas(1200, 1200);
+        Text::setSmoothing(true);
+        Text::drawText("FERN", 0, 0, 3, 0xFFFFFFFF);
+        std::vector<uint32_t> first = canvas.pixels();
+
+        // Far more than the cache holds.
+        for (int scale = 20; scale <= 30; ++scale) {
+            Text::drawText("ABCDEFGHIJ", 0, 0, scale, 0xFF00FF00);
+        }
+        Text::drawChar('W', 0, 0, 130, 0xFF0000FF);
+
+        canvas.clear();
+        Text::drawText("FERN", 0, 0, 3, 0xFFFFFFFF);
+        CHECK(first == canvas.pixels());
+        CHECK(canvas.at(2, 2) != 0);
+        Text::setSmoothing(false);
+    }
+}
+
+int main() {
+    testSmoothGlyphsAfterEviction();
+    return FernTest::finish("text");
+}
@@ -0,0 +1,78 @@
+#include "fern/core/thread_pool.hpp"
+#include "test.hpp"
+#include <atomic>
+#include <vector>
+
+using namespace Fern;
+
+namespace {
+    // Every index is visited exactly once, however the chunks are stolen.
+    void testParallelFor() {
+        std::vector<int> visits(1000003, 0);
+        for (int round = 0; round < 20; ++round) {
+            parallelFor(0, (int)visits.size(), 997, [&](int begin, int end) {
+                for (int i = begin; i < end; ++i) visits[i]++;
+            });
+        }
+        bool exact = true;
+        for (int v : visits) exact &= v == 20;
+        CHECK(exact);
+
+        int calls = 0;
+        parallelFor(5, 5, 1, [&](int, int) { calls++; });
+        parallelFor(0, 10, 100, [&](int begin, int end) { calls += end - begin; });
+        CHECK_EQ(calls, 10);
+    }
+
+    // Tiles cover the area once, edge tiles clipped; nested parallel loops
+    // inside a tile must not deadlock.
+    void testTiles() {
+        const Rect area(3, 5, 1001, 333);
+        std::vector<std::atomic<int>> cover((size_t)area.width * area.height);
+        for (auto& c : cover) c.store(0);
+        std::atomic<int> nested{0};
+
+        parallelForTiles(area, 64, 48, [&](const Rect& tile) {
+            for (int y = tile.y; y < tile.y + tile.height; ++y) {
+                for (int x = tile.x; x < tile.x + tile.width; ++x) {
+                    cover[(size_t)(y - area.y) * area.width + (x - area.x)]++;
+                }
+            }
+            parallelFor(0, 8, 1, [&](int begin, int end) { nested += end - begin; });
+        });
+
+        bool once = true;
+        for (auto& c : cover) once &= c.load() == 1;
+        CHECK(once);
+        int tiles = ((area.width + 63) / 64) * ((area.height + 47) / 48);
+        CHECK_EQ(nested.load(), tiles * 8);
+    }
+
+    void testTaskGroups() {
+        std::atomic<int> done{0};
+        {
+            TaskGroup outer;
+            for (int i = 0; i < 16; ++i) {
+                outer.run([&] {
+                    TaskGroup inner;
+                    for (int k = 0; k < 16; ++k) inner.run([&] { done++; });
+                    inner.wait();
+                });
+            }
+            outer.wait();
+            CHECK_EQ(done.load(), 256);
+        }
+        for (int round = 0; round < 1000; ++round) {
+            TaskGroup group;
+            group.run([&] { done++; });
+        }
+        CHECK_EQ(done.load(), 1256);
+    }
+}
+
+int main() {
+    testParallelFor();
+    testTiles();
+    testTaskGroups();
+    return FernTest::finish("thread_pool");
+}
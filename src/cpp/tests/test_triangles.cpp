@@ -0,0 +1,121 @@
+#include "fern/graphics/primitives.hpp"
+#include "test.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+using namespace Fern;
+
+namespace {
+    const int W = 400, H = 300;
+
+    int64_t edge(const Point& a, const Point& b, int x, int y) {
+        return (int64_t)(b.x - a.x) * (y - a.y) - (int64_t)(b.y - a.y) * (x - a.x);
+    }
+
+    // Fans of triangles around a shared center: no pixel is drawn by two
+    // triangles sharing an edge, every pixel strictly inside a triangle is
+    // drawn and nothing strictly outside is.
+    void testSharedEdges() {
+        FernTest::TestCanvas canvas(W, H);
+        std::srand(7);
+        long doubleDrawn = 0, wrong = 0;
+        for (int trial = 0; trial < 60; ++trial) {
+            int count = 4 + std::rand() % 20;
+            Point center(std::rand() % W, std::rand() % H);
+            std::vector<Point> vertices{center};
+            for (int i = 0; i < count; ++i) {
+                double angle = (i + 0.9 * std::rand() / RAND_MAX) * 2 * 3.14159265358979 / count;
+                double radius = 20 + std::rand() % 200;
+                vertices.push_back(Point((int)(center.x + radius * std::cos(angle)),
+                                         (int)(center.y + radius * std::sin(angle))));
+            }
+
+            std::vector<int> coverage(W * H, 0);
+            for (int i = 0; i < count; ++i) {
+                canvas.clear();
+                int b = 1 + i, c = 1 + (i + 1) % count;
+                Draw::triangles(vertices, {0, b, c}, {0xFFFFFFFF}, Shading::Flat);
+                for (int k = 0; k < W * H; ++k) coverage[k] += canvas.pixels()[k] != 0;
+
+                const Point &p0 = vertices[0], &p1 = vertices[b], &p2 = vertices[c];
+                int64_t area = edge(p0, p1, p2.x, p2.y);
+                if (area == 0) continue;
+                for (int y = 0; y < H; ++y) {
+                    for (int x = 0; x < W; ++x) {
+                        int64_t e0 = edge(p0, p1, x, y), e1 = edge(p1, p2, x, y), e2 = edge(p2, p0, x, y);
+                        if (area < 0) {
+                            e0 = -e0;
+                            e1 = -e1;
+                            e2 = -e2;
+                        }
+                        bool drawn = canvas.at(x, y) != 0;
+                        if (e0 > 0 && e1 > 0 && e2 > 0 && !drawn) wrong++;
+                        if ((e0 < 0 || e1 < 0 || e2 < 0) && drawn) wrong++;
+                    }
+                }
+            }
+            for (int k = 0; k < W * H; ++k) doubleDrawn += coverage[k] > 1;
+        }
+        CHECK_EQ(doubleDrawn, 0);
+        CHECK_EQ(wrong, 0);
+    }
+
+    void testGouraudCorners() {
+        FernTest::TestCanvas canvas(W, H);
+        Draw::triangles({Point(0, 0), Point(W - 1, 0), Point(0, H - 1)}, {0, 1, 2},
+                        {0xFFFF0000, 0xFF00FF00, 0xFF0000FF});
+        CHECK_EQ(canvas.at(0, 0), 0xFFFF0000u);
+        uint32_t nearGreen = canvas.at(W - 3, 0), nearBlue = canvas.at(0, H - 3);
+        CHECK(((nearGreen >> 8) & 0xFF) > 0xF0 && ((nearGreen >> 16) & 0xFF) < 0x10);
+        CHECK((nearBlue & 0xFF) > 0xF0 && ((nearBlue >> 16) & 0xFF) < 0x10);
+    }
+
+    // A large batch is binned and drawn in parallel; the result must be
+    // what drawing the triangles one call at a time gives.
+    void testBatchMatchesSerial() {
+        FernTest::TestCanvas canvas(W, H);
+        std::srand(9);
+        std::vector<Point> vertices;
+        std::vector<int> indices;
+        std::vector<uint32_t> colors;
+        for (int i = 0; i < 20000; ++i) {
+            int x = std::rand() % W, y = std::rand() % H;
+            vertices.push_back(Point(x, y));
+            vertices.push_back(Point(x + std::rand() % 30 - 15, y + std::rand() % 30 - 15));
+            vertices.push_back(Point(x + std::rand() % 30 - 15, y + std::rand() % 30 - 15));
+            for (int k = 0; k < 3; ++k) {
+                indices.push_back(3 * i + k);
+                colors.push_back(0xFF000000 | (uint32_t)std::rand());
+            }
+        }
+        Draw::triangles(vertices, indices, colors, Shading::Gouraud);
+        std::vector<uint32_t> batched = canvas.pixels();
+
+        canvas.clear();
+        for (size_t i = 0; i < indices.size(); i += 3) {
+            Draw::triangles(vertices, {indices[i], indices[i + 1], indices[i + 2]}, colors,
+                            Shading::Gouraud);
+        }
+        CHECK(batched == canvas.pixels());
+    }
+
+    void testInvalidInput() {
+        FernTest::TestCanvas canvas(20, 20);
+        Draw::triangles({Point(0, 0), Point(10, 0)}, {0, 1, 5}, {1});
+        Draw::triangles({Point(0, 0), Point(10, 0), Point(0, 10)}, {0, 1}, {1});
+        Draw::triangles({Point(0, 0), Point(10, 0), Point(0, 10)}, {0, 1, 2}, {});
+        long drawn = 0;
+        for (uint32_t p : canvas.pixels()) drawn += p != 0;
+        CHECK_EQ(drawn, 0);
+    }
+}
+
+int main() {
+    testSharedEdges();
+    testGouraudCorners();
+    testBatchMatchesSerial();
+    testInvalidInput();
+    return FernTest::finish("triangles");
+}
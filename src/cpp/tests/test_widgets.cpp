@@ -0,0 +1,241 @@
+#include "fern/core/input.hpp"
+#include "fern/core/widget_manager.hpp"
+#include "fern/ui/button.hpp"
+#include "fern/ui/container.hpp"
+#include "../src/core/widget_pool.hpp"
+#include "test.hpp"
+#include <atomic>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+
+using namespace Fern;
+
+namespace {
+    struct Tracked {
+        static std::atomic<int> alive;
+        int value[6];
+        explicit Tracked(int v) { value[0] = v; alive++; }
+        ~Tracked() { alive--; }
+    };
+    std::atomic<int> Tracked::alive{0};
+
+    // Pooled objects are created on one thread and released on others, as
+    // when a worker holds the last reference to a widget.
+    void testPoolAcrossThreads() {
+        const int THREADS = 4, ROUNDS = 20000;
+        std::vector<std::thread> threads;
+        std::atomic<bool> intact{true};
+        for (int t = 0; t < THREADS; ++t) {
+            threads.emplace_back([&, t] {
+                std::vector<std::shared_ptr<Tracked>> held;
+                for (int i = 0; i < ROUNDS; ++i) {
+                    held.push_back(WidgetPool::make<Tracked>(t * ROUNDS + i));
+                    if (held.size() > 32) {
+                        // Blocks handed out twice would have been overwritten.
+                        if (held.front()->value[0] != t * ROUNDS + i - 32) intact = false;
+                        held.erase(held.begin());
+                    }
+                }
+            });
+        }
+        for (std::thread& thread : threads) thread.join();
+        CHECK(intact.load());
+        CHECK_EQ(Tracked::alive.load(), 0);
+
+        // Live objects never share a block.
+        std::vector<std::shared_ptr<Tracked>> live;
+        std::set<const Tracked*> addresses;
+        for (int i = 0; i < 500; ++i) {
+            live.push_back(WidgetPool::make<Tracked>(i));
+            addresses.insert(live.back().get());
+        }
+        CHECK_EQ(addresses.size(), live.size());
+    }
+
+    // Records what the manager sends it; consumes clicks when asked to.
+    struct Probe : Widget {
+        Rect area;
+        bool consumeClicks;
+        int updates = 0;
+        int clicks = 0;
+        bool hovered = false;
+
+        Probe(const Rect& area, bool consumeClicks) : area(area), consumeClicks(consumeClicks) {}
+        void render() override {}
+        bool getBounds(Rect& bounds) const override { bounds = area; return true; }
+        bool handleInput(const InputState& input) override {
+            updates++;
+            hovered = area.contains(input.mouseX, input.mouseY);
+            if (hovered && input.mouseClicked) {
+                clicks++;
+                return consumeClicks;
+            }
+            return false;
+        }
+    };
+
+    // One iteration of the render loop's input handling.
+    void frame() {
+        Input::pollEvents();
+        WidgetManager::getInstance().processInput();
+        Input::resetEvents();
+    }
+
+    void click() {
+        Input::updateMouseButton(true);
+        frame();
+        Input::updateMouseButton(false);
+        frame();
+    }
+
+    // The topmost widget under the pointer sees a click first and stops it
+    // from reaching the widgets below.
+    void testDispatchOrder() {
+        auto bottom = std::make_shared<Probe>(Rect(0, 0, 100, 100), true);
+        auto top = std::make_shared<Probe>(Rect(50, 50, 100, 100), true);
+        addWidget(bottom);
+        addWidget(top);
+
+        Input::updateMousePosition(75, 75);
+        click();
+        CHECK_EQ(top->clicks, 1);
+        CHECK_EQ(bottom->clicks, 0);
+
+        Input::updateMousePosition(25, 25);
+        click();
+        CHECK_EQ(top->clicks, 1);
+        CHECK_EQ(bottom->clicks, 1);
+
+        // Once the top widget is gone, clicks fall through to the bottom one.
+        removeWidget(top);
+        Input::updateMousePosition(75, 75);
+        click();
+        CHECK_EQ(bottom->clicks, 2);
+        removeWidget(bottom);
+        frame();
+    }
+
+    // A widget hears about the pointer leaving it, including when the frame
+    // it leaves in is handled by a widget above it.
+    void testHoverClears() {
+        auto lower = std::make_shared<Probe>(Rect(0, 0, 50, 50), false);
+        auto upper = std::make_shared<Probe>(Rect(100, 0, 50, 50), true);
+        addWidget(lower);
+        addWidget(upper);
+
+        Input::updateMousePosition(10, 10);
+        frame();
+        CHECK(lower->hovered);
+        Input::updateMousePosition(300, 300);
+        frame();
+        CHECK(!lower->hovered);
+
+        // Hover the lower widget, then move onto the upper one and click in
+        // the same frame: the click stops dispatch at the upper widget.
+        Input::updateMousePosition(10, 10);
+        frame();
+        CHECK(lower->hovered);
+        Input::updateMousePosition(110, 10);
+        Input::updateMouseButton(true);
+        frame();
+        CHECK_EQ(upper->clicks, 1);
+        for (int i = 0; i < 3; ++i) frame();
+        CHECK(!lower->hovered);
+        CHECK(upper->hovered);
+
+        Input::updateMouseButton(false);
+        frame();
+        removeWidget(lower);
+        removeWidget(upper);
+        frame();
+    }
+
+    // Frames without input events skip dispatch, except for ticking widgets.
+    void testIdleFrames() {
+        WidgetManager& manager = WidgetManager::getInstance();
+        auto still = std::make_shared<Probe>(Rect(0, 0, 50, 50), false);
+        auto ticking = std::make_shared<Probe>(Rect(100, 0, 50, 50), false);
+        addWidget(still);
+        manager.setTicking(addWidget(ticking), true);
+
+        Input::updateMousePosition(10, 10);
+        frame();
+        int stillUpdates = still->updates;
+        int tickingUpdates = ticking->updates;
+        CHECK(stillUpdates > 0);
+        for (int i = 0; i < 5; ++i) frame();
+        CHECK_EQ(still->updates, stillUpdates);
+        CHECK_EQ(ticking->updates, tickingUpdates + 5);
+
+        // Moving to the same position is not an event either.
+        Input::updateMousePosition(10, 10);
+        frame();
+        CHECK_EQ(still->updates, stillUpdates);
+
+        removeWidget(still);
+        removeWidget(ticking);
+        frame();
+    }
+
+    // Widgets far outside the canvas do not size the grid: with a canvas it
+    // is clipped to it, without one it falls back to plain dispatch.
+    void testFarBounds() {
+        auto huge = std::make_shared<Probe>(Rect(-1000000000, -1000000000, 2000000000, 2000000000), false);
+        auto far = std::make_shared<Probe>(Rect(1000000000, 1000000000, 10, 10), true);
+        auto near = std::make_shared<Probe>(Rect(10, 10, 20, 20), true);
+        for (int withCanvas = 0; withCanvas < 2; ++withCanvas) {
+            std::unique_ptr<FernTest::TestCanvas> canvas;
+            if (withCanvas) canvas.reset(new FernTest::TestCanvas(200, 100));
+            addWidget(huge);
+            addWidget(far);
+            addWidget(near);
+
+            Input::updateMousePosition(15, 15);
+            click();
+            CHECK_EQ(near->clicks, withCanvas + 1);
+            CHECK(huge->hovered);
+            Input::updateMousePosition(150, 50);
+            frame();
+            CHECK(!near->hovered);
+            CHECK(huge->hovered);
+
+            removeWidget(huge);
+            removeWidget(far);
+            removeWidget(near);
+            frame();
+        }
+    }
+
+    void testHandles() {
+        WidgetManager& manager = WidgetManager::getInstance();
+        auto container = ContainerWidget(0, 0, 10, 10, 0xFF000000);
+        WidgetHandle handle = manager.findHandle(container.get());
+        CHECK(handle.isValid());
+        CHECK_EQ(manager.getWidget(handle), container.get());
+
+        manager.removeWidget(handle);
+        CHECK(manager.getWidget(handle) == nullptr);
+
+        // The freed slot is reused under a new generation; the old handle
+        // stays stale.
+        auto other = ContainerWidget(5, 5, 10, 10, 0xFF000000);
+        WidgetHandle reused = manager.findHandle(other.get());
+        CHECK(reused != handle);
+        CHECK(manager.getWidget(handle) == nullptr);
+        manager.removeWidget(handle);
+        CHECK_EQ(manager.getWidget(reused), other.get());
+        manager.removeWidget(reused);
+    }
+}
+
+int main() {
+    testPoolAcrossThreads();
+    testHandles();
+    testDispatchOrder();
+    testHoverClears();
+    testIdleFrames();
+    testFarBounds();
+    return FernTest::finish("widgets");
+}